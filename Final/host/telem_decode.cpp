@@ -0,0 +1,847 @@
+//**************************************************************************************
+/** @file telem_decode.cpp
+ *    This file contains a program which runs on a Linux PC and decodes the binary 
+ *    telemetry sent by the car's telemetry task. It finds the COBS frames between zero
+ *    bytes, checks their CRC's, and prints the records as text or as CSV. Anything 
+ *    else, such as console text when telemetry shares the console port, is copied to
+ *    the standard error stream so that it doesn't get mixed into the data.
+ *
+ *    To build and run it:
+ *    @code
+ *    g++ -O2 -o telem_decode telem_decode.cpp
+ *    ./telem_decode -b 500000 /dev/ttyUSB1            # Readable text
+ *    ./telem_decode -c -b 500000 /dev/ttyUSB1 > run.csv
+ *    ./telem_decode -c < captured.bin                  # Decode a saved capture
+ *    ./telem_decode -l build/proj.dlog -b 500000 /dev/ttyUSB1   # With log messages
+ *    ./telem_decode -t trace.json -b 500000 /dev/ttyUSB1        # Save RTOS traces
+ *    @endcode
+ *    Log records from @c DLOG() statements are printed using the format table which
+ *    @c make copies out of the ELF file; the table must come from the same build as
+ *    the program in the AVR. Without a table, only the log statements' ID's are shown.
+ *    With CSV output, each line begins with the record type's name; a header line 
+ *    beginning with '#' is printed the first time each type of record is seen.
+ *
+ *    When the program in the AVR is built with @c -DTASK_TRACE, the 'T' command of 
+ *    the user interface freezes the RTOS trace and the telemetry task sends it. With 
+ *    @c -t, each trace received is written to the given file, replacing the one
+ *    before, in the Chrome trace event format; open it at @c chrome://tracing or 
+ *    https://ui.perfetto.dev to see each task's runs, each marked ISR's runs, and the
+ *    queue, semaphore and mutex operations on a timeline.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 KM file created for the binary telemetry link.
+ *    @li 10-17-2026 KM decodes deferred-format log records with @c -l.
+ *    @li 10-17-2026 KM writes RTOS traces as Chrome trace event files with @c -t.
+ *    @li 10-17-2026 KM frame constants come from lib/serial/telem_protocol.h.
+ *    @li 10-17-2026 KM so do the trace event and trace frame codes.
+ *  
+ *  License:
+ *	This code is based on Prof. JR Ridgely's FreeRTOS CPP example code. The FreeRTOS
+ *	framework is used, but the tasks are a product of our 507 group. Since the original
+ *	code used the LGPL, our code will also use the LGPL.
+ *		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * 		IMPLIED 	WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * 		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * 		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ * 		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * 		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * 		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * 		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * 		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <termios.h>
+
+#include "../../lib/serial/telem_protocol.h"  // Frame, record and trace codes
+#include "../telemetry_records.h"           // The records sent by the AVR
+
+
+/// The largest frame which can be sent, plus the one COBS code byte added to it.
+const size_t MAX_FRAME = TELEM_MAX_PAYLOAD + TELEM_OVERHEAD + 1;
+
+/// The largest number of records in a trace; the AVR's buffer has at most 256.
+const size_t TRACE_MAX_RECORDS = 256;
+
+/// Timeline rows for ISR's are numbered from here, after the rows for tasks.
+const unsigned TRACE_ISR_ROW = 256;
+
+/// The number of bytes of argument type codes at the start of each log table entry.
+const size_t LOG_CODES = 5;
+
+/// The longest chunk of text between zeros which is kept before being printed.
+const size_t MAX_CHUNK = 1024;
+
+
+/// True if records are printed as comma separated values.
+static bool csv_output = false;
+
+/// Counts of frames decoded, frames which failed their checks, and frames missed.
+static unsigned long good_frames = 0, bad_frames = 0, missed_frames = 0;
+
+/// The log format table read from the file given with @c -l, and its size.
+static char* p_log_table = NULL;
+static size_t log_table_size = 0;
+
+/// The file to which each RTOS trace is written, given with @c -t.
+static const char* p_trace_file = NULL;
+
+/// The RTOS trace being put together from its frames.
+static struct
+{
+	bool started;                           ///< True once a start frame has come
+	uint8_t shift;                          ///< Timer count shift in the time stamps
+	uint16_t counts_per_tick;               ///< Hardware timer counts per RTOS tick
+	uint32_t counts_per_second;             ///< Hardware timer counts per second
+	char task_names[256][16];               ///< Names of tasks, by task number
+	char isr_names[256][16];                ///< Names of ISR's, by ISR number
+	uint8_t records[TRACE_MAX_RECORDS][4];  ///< Type, number and time stamp
+	size_t n_records;                       ///< Number of records received
+} trace;
+
+
+//-------------------------------------------------------------------------------------
+/** This function adds one byte to a CRC-16/CCITT-FALSE calculation. It must match
+ *  telem_crc16() in lib/serial/telemetry.h, which the AVR uses.
+ *  @param crc The CRC of the bytes before this one
+ *  @param data The byte to be added to the CRC
+ *  @return The CRC including the new byte
+ */
+
+static uint16_t crc16 (uint16_t crc, uint8_t data)
+{
+	crc ^= (uint16_t)data << 8;
+	for (int bit = 0; bit < 8; bit++)
+	{
+		crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+	}
+	return (crc);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function undoes COBS encoding. The input must not contain zeros, as the zeros
+ *  which separated frames have already been removed. 
+ *  @param p_in The encoded bytes
+ *  @param length The number of encoded bytes
+ *  @param p_out A buffer at least @c length bytes long for the decoded bytes
+ *  @return The number of decoded bytes, or -1 if the input isn't valid COBS
+ */
+
+static int cobs_decode (const uint8_t* p_in, size_t length, uint8_t* p_out)
+{
+	size_t i_in = 0;
+	size_t i_out = 0;
+
+	while (i_in < length)
+	{
+		uint8_t code = p_in[i_in++];
+		if (code == 0 || i_in + code - 1 > length)
+		{
+			return (-1);
+		}
+		for (uint8_t count = 1; count < code; count++)
+		{
+			p_out[i_out++] = p_in[i_in++];
+		}
+		if (code < 0xFF && i_in < length)
+		{
+			p_out[i_out++] = 0;
+		}
+	}
+	return ((int)i_out);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function prints a CSV header line for a type of record the first time that
+ *  type is seen. 
+ *  @param type The record type code
+ *  @param p_header The header line, without the leading '#'
+ */
+
+static void csv_header (uint8_t type, const char* p_header)
+{
+	static bool seen[256];
+
+	if (csv_output && !seen[type])
+	{
+		seen[type] = true;
+		printf ("#%s\n", p_header);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function reads a file into memory. 
+ *  @param p_name The name of the file
+ *  @param p_size Set to the number of bytes in the file
+ *  @return Pointer to the file's contents, with a zero added, or NULL if it can't be
+ *          read
+ */
+
+static char* read_file (const char* p_name, size_t* p_size)
+{
+	FILE* p_file = fopen (p_name, "rb");
+	char* p_data = NULL;
+	long size;
+
+	if (p_file != NULL && fseek (p_file, 0, SEEK_END) == 0 && (size = ftell (p_file)) > 0)
+	{
+		rewind (p_file);
+		p_data = (char*)calloc (size + 1, 1);
+		if (fread (p_data, 1, size, p_file) != (size_t)size)
+		{
+			free (p_data);
+			p_data = NULL;
+		}
+		*p_size = size;
+	}
+	if (p_file != NULL)
+	{
+		fclose (p_file);
+	}
+	return (p_data);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function gets one log argument from its bytes. Integers are sign extended if 
+ *  their type is signed; this PC, like the AVR, is assumed to be little-endian.
+ *  @param code The argument's type code, as used by Python's @c struct module
+ *  @param p_args The bytes of this argument and any after it
+ *  @param n_bytes The number of bytes left
+ *  @param p_integer Set to the argument's value if it's an integer
+ *  @param p_real Set to the argument's value if it's a floating point number
+ *  @return The number of bytes the argument took, or 0 if it's missing or its type
+ *          code isn't known
+ */
+
+static size_t get_argument (char code, const uint8_t* p_args, size_t n_bytes,
+							long long* p_integer, double* p_real)
+{
+	const char* p_size = strchr ("bB?c1hH2iIf4qQd8", code);
+	uint64_t raw = 0;
+	float single;
+
+	// The size digit follows the codes for each size
+	while (p_size != NULL && *p_size > '9')
+	{
+		p_size++;
+	}
+	if (code == '\0' || p_size == NULL || n_bytes < (size_t)(*p_size - '0'))
+	{
+		return (0);
+	}
+	size_t size = *p_size - '0';
+
+	memcpy (&raw, p_args, size);
+	if (strchr ("bhiq", code) && size < 8 && (raw & (1ULL << (8 * size - 1))))
+	{
+		raw |= ~0ULL << (8 * size);
+	}
+	*p_integer = (long long)raw;
+	if (code == 'f')
+	{
+		memcpy (&single, p_args, sizeof (single));
+		*p_real = single;
+	}
+	else if (code == 'd')
+	{
+		memcpy (p_real, p_args, sizeof (double));
+	}
+	return (size);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function prints a log message, putting the arguments into the format string 
+ *  from the table. Each conversion in the format takes the next argument; the size of
+ *  the argument comes from its type code, so length modifiers such as @c l in the 
+ *  format are ignored. 
+ *  @param p_codes The argument type codes, ending with a zero
+ *  @param p_format The format string
+ *  @param p_args The arguments' bytes
+ *  @param n_bytes The number of bytes of arguments
+ *  @param p_out The file to which the message is printed
+ *  @return True if the arguments matched the type codes
+ */
+
+static bool print_log_message (const char* p_codes, const char* p_format, 
+							   const uint8_t* p_args, size_t n_bytes, FILE* p_out)
+{
+	char spec[32];                          // One conversion specification
+	size_t i_spec;
+
+	while (*p_format)
+	{
+		if (*p_format != '%' || p_format[1] == '%')
+		{
+			fputc (*p_format, p_out);
+			p_format += (*p_format == '%') ? 2 : 1;
+			continue;
+		}
+
+		// Copy the flags, width and precision, leaving out length modifiers
+		i_spec = 0;
+		spec[i_spec++] = *p_format++;
+		while (*p_format && strchr ("diouxXcfeEgGs", *p_format) == NULL)
+		{
+			if (strchr ("hlLqjzt", *p_format) == NULL && i_spec < sizeof (spec) - 4)
+			{
+				spec[i_spec++] = *p_format;
+			}
+			p_format++;
+		}
+		char conversion = *p_format;
+		if (conversion == '\0' || *p_codes == '\0')
+		{
+			fputs ("<missing argument>", p_out);
+			return (false);
+		}
+		p_format++;
+
+		// Get the argument from its bytes according to its type code
+		long long integer;
+		double real;
+		size_t size = get_argument (*p_codes, p_args, n_bytes, &integer, &real);
+		if (size == 0)
+		{
+			fputs ("<missing argument>", p_out);
+			return (false);
+		}
+		bool is_real = (*p_codes == 'f' || *p_codes == 'd');
+		p_args += size;
+		n_bytes -= size;
+		p_codes++;
+
+		// Print the argument in the way the format asks, whatever its type was
+		if (strchr ("feEgG", conversion))
+		{
+			spec[i_spec++] = conversion;
+			spec[i_spec] = '\0';
+			fprintf (p_out, spec, is_real ? real : (double)integer);
+		}
+		else if (conversion == 'c')
+		{
+			spec[i_spec++] = 'c';
+			spec[i_spec] = '\0';
+			fprintf (p_out, spec, (int)integer);
+		}
+		else
+		{
+			spec[i_spec++] = 'l';
+			spec[i_spec++] = 'l';
+			spec[i_spec++] = (conversion == 's') ? 'd' : conversion;
+			spec[i_spec] = '\0';
+			fprintf (p_out, spec, is_real ? (long long)real : integer);
+		}
+	}
+	return (*p_codes == '\0' && n_bytes == 0);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function prints the log records in one frame. Each record is the number of 
+ *  argument bytes, a two-byte ID, and the arguments.
+ *  @param p_data The frame's payload
+ *  @param length The number of bytes in the payload
+ *  @return True if the records fit the payload exactly
+ */
+
+static bool print_log_records (const uint8_t* p_data, size_t length)
+{
+	while (length >= 3 && (size_t)p_data[0] + 3 <= length)
+	{
+		size_t n_bytes = p_data[0];
+		uint16_t id = p_data[1] | (p_data[2] << 8);
+		const uint8_t* p_args = p_data + 3;
+
+		csv_header (TELEM_LOG, "log,where,message");
+		if (p_log_table == NULL || id + LOG_CODES >= log_table_size)
+		{
+			printf (csv_output ? "log,0x%04x,%u bytes\n" : "log     id 0x%04x, %u bytes\n",
+					id, (unsigned)n_bytes);
+		}
+		else
+		{
+			const char* p_codes = p_log_table + id;
+			const char* p_where = p_codes + LOG_CODES;
+			const char* p_format = p_where + strlen (p_where) + 1;
+
+			printf (csv_output ? "log,%s,\"" : "log     %s: ", p_where);
+			print_log_message (p_codes, p_format, p_args, n_bytes, stdout);
+			printf (csv_output ? "\"\n" : "\n");
+		}
+		p_data += n_bytes + 3;
+		length -= n_bytes + 3;
+	}
+	return (length == 0);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function writes one event of an RTOS trace in the Chrome trace event format.
+ *  @param p_file The file to which the event is written
+ *  @param p_name The name of the event
+ *  @param phase 'B' or 'E' for the beginning or end of a run, 'i' for an instant
+ *  @param time_us The time of the event in microseconds
+ *  @param row The timeline row, which is the task number or an ISR row
+ */
+
+static void trace_json_event (FILE* p_file, const char* p_name, char phase, 
+							  double time_us, unsigned row)
+{
+	fprintf (p_file, ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.1f,\"pid\":1,"
+			 "\"tid\":%u%s}", p_name, phase, time_us, row, 
+			 (phase == 'i') ? ",\"s\":\"t\"" : "");
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function writes the name of one timeline row in the Chrome trace format.
+ *  @param p_file The file to which the name is written
+ *  @param row The timeline row, which is the task number or an ISR row
+ *  @param p_name The name of the row
+ */
+
+static void trace_json_row (FILE* p_file, unsigned row, const char* p_name)
+{
+	fprintf (p_file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+			 "\"args\":{\"name\":\"%s\"}}", row, p_name);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function writes the RTOS trace which has been received to the file given 
+ *  with @c -t, as a Chrome trace event file. Each time stamp holds the low byte of 
+ *  the RTOS tick count and the hardware timer count; the ticks are counted from the
+ *  first record, adding one wrap of the low byte each time it goes down. Each task 
+ *  switch ends the run of the task which was running and begins the next task's run.
+ *  Queue operations are shown as instants in the row of the task, or the ISR, which
+ *  did them.
+ *  @return True if the file was written
+ */
+
+static bool write_trace (void)
+{
+	FILE* p_file = fopen (p_trace_file, "w");
+	bool task_seen[256] = { false };
+	bool isr_seen[256] = { false };
+	char name[64];
+	int task = -1;                          // Task which is running, if known
+	int isr = -1;                           // ISR which is running, if any
+	uint64_t tick = 0;                      // Ticks since the first record
+	uint8_t last_tick = 0;                  // Low byte of the previous record's tick
+	double time_us = 0.0;
+
+	if (p_file == NULL)
+	{
+		perror (p_trace_file);
+		return (false);
+	}
+	fprintf (p_file, "{\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\","
+			 "\"pid\":1,\"args\":{\"name\":\"AVR\"}}");
+
+	for (size_t index = 0; index < trace.n_records; index++)
+	{
+		uint8_t type = trace.records[index][0];
+		uint8_t number = trace.records[index][1];
+		uint8_t stamp_tick = trace.records[index][3];
+		uint8_t stamp_count = trace.records[index][2];
+
+		tick += (index == 0) ? 0 : (uint8_t)(stamp_tick - last_tick);
+		last_tick = stamp_tick;
+		time_us = ((double)tick * trace.counts_per_tick 
+				   + ((unsigned)stamp_count << trace.shift))
+				  * 1.0e6 / trace.counts_per_second;
+
+		// Queue operations go in the row of whatever did them
+		unsigned row = (isr >= 0) ? TRACE_ISR_ROW + isr : (task >= 0 ? task : 0);
+		switch (type)
+		{
+			case TRACE_SWITCH:
+				if (task >= 0)
+				{
+					trace_json_event (p_file, "run", 'E', time_us, task);
+				}
+				task = number;
+				task_seen[number] = true;
+				trace_json_event (p_file, "run", 'B', time_us, task);
+				break;
+			case TRACE_ISR_BEGIN:
+				isr = number;
+				isr_seen[number] = true;
+				trace_json_event (p_file, "ISR", 'B', time_us, TRACE_ISR_ROW + isr);
+				break;
+			case TRACE_ISR_END:
+				trace_json_event (p_file, "ISR", 'E', time_us, TRACE_ISR_ROW + number);
+				isr = -1;
+				break;
+			case TRACE_SEND:
+			case TRACE_SEND_ISR:
+				snprintf (name, sizeof (name), "send Q%u", number);
+				trace_json_event (p_file, name, 'i', time_us, row);
+				break;
+			case TRACE_RECEIVE:
+			case TRACE_RECEIVE_ISR:
+				snprintf (name, sizeof (name), "receive Q%u", number);
+				trace_json_event (p_file, name, 'i', time_us, row);
+				break;
+			case TRACE_SEND_FAILED:
+				snprintf (name, sizeof (name), "send Q%u failed", number);
+				trace_json_event (p_file, name, 'i', time_us, row);
+				break;
+			case TRACE_RECEIVE_FAILED:
+				snprintf (name, sizeof (name), "receive Q%u failed", number);
+				trace_json_event (p_file, name, 'i', time_us, row);
+				break;
+			case TRACE_BLOCK_SEND:
+				snprintf (name, sizeof (name), "wait to send Q%u", number);
+				trace_json_event (p_file, name, 'i', time_us, row);
+				break;
+			case TRACE_BLOCK_RECEIVE:
+				snprintf (name, sizeof (name), "wait to receive Q%u", number);
+				trace_json_event (p_file, name, 'i', time_us, row);
+				break;
+			default:                        // Tick marks are only used for time
+				break;
+		}
+	}
+
+	// End the runs still going at the last record, then name the rows
+	if (isr >= 0)
+	{
+		trace_json_event (p_file, "ISR", 'E', time_us, TRACE_ISR_ROW + isr);
+	}
+	if (task >= 0)
+	{
+		trace_json_event (p_file, "run", 'E', time_us, task);
+	}
+	for (unsigned number = 0; number < 256; number++)
+	{
+		if (task_seen[number])
+		{
+			snprintf (name, sizeof (name), "%s", trace.task_names[number][0] 
+					  ? trace.task_names[number] : "task");
+			trace_json_row (p_file, number, name);
+		}
+		if (isr_seen[number])
+		{
+			snprintf (name, sizeof (name), "ISR %s", trace.isr_names[number][0] 
+					  ? trace.isr_names[number] : "");
+			trace_json_row (p_file, TRACE_ISR_ROW + number, name);
+		}
+	}
+	fprintf (p_file, "\n]}\n");
+	fclose (p_file);
+	return (true);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function collects one frame of an RTOS trace. A start frame begins a new 
+ *  trace; name frames and record frames add to it; and the end frame, which holds the
+ *  number of records sent, finishes it. Then a line about the trace is printed, and if
+ *  a file was given with @c -t, the trace is written to it. Names are kept with 
+ *  anything which would upset a JSON string changed to '_'.
+ *  @param p_data The frame's payload
+ *  @param length The number of bytes in the payload
+ *  @return True if the frame made sense
+ */
+
+static bool collect_trace (const uint8_t* p_data, size_t length)
+{
+	if (length >= 11 && p_data[0] == TRACE_FRAME_START)
+	{
+		memset (&trace, 0, sizeof (trace));
+		trace.started = true;
+		trace.shift = p_data[4];
+		trace.counts_per_tick = p_data[5] | (p_data[6] << 8);
+		memcpy (&trace.counts_per_second, p_data + 7, sizeof (uint32_t));
+		return (trace.counts_per_second != 0);
+	}
+	if (!trace.started)
+	{
+		return (length >= 1 && p_data[0] <= TRACE_FRAME_END);
+	}
+	if (length >= 3 && p_data[0] == TRACE_FRAME_NAME && p_data[1] <= TRACE_NAME_ISR)
+	{
+		char* p_name = (p_data[1] == TRACE_NAME_TASK) ? trace.task_names[p_data[2]]
+													  : trace.isr_names[p_data[2]];
+		size_t index;
+		for (index = 0; index + 3 < length && index < 15; index++)
+		{
+			char ch = p_data[index + 3];
+			bool bad = (ch < ' ' || ch == '"' || ch == '\\' || ch >= 0x7F);
+			p_name[index] = bad ? '_' : ch;
+		}
+		p_name[index] = '\0';
+		return (true);
+	}
+	if (length >= 1 && p_data[0] == TRACE_FRAME_RECORDS && (length - 1) % 4 == 0)
+	{
+		for (size_t index = 1; index < length && trace.n_records < TRACE_MAX_RECORDS;
+			 index += 4)
+		{
+			memcpy (trace.records[trace.n_records++], p_data + index, 4);
+		}
+		return (true);
+	}
+	if (length == 3 && p_data[0] == TRACE_FRAME_END)
+	{
+		unsigned sent = p_data[1] | (p_data[2] << 8);
+		bool written = (p_trace_file != NULL && write_trace ());
+
+		csv_header (TELEM_TRACE, "trace,records,sent,file");
+		if (csv_output)
+		{
+			printf ("trace,%u,%u,%s\n", (unsigned)trace.n_records, sent,
+					written ? p_trace_file : "");
+		}
+		else
+		{
+			printf ("trace   %u of %u records%s%s\n", (unsigned)trace.n_records, sent,
+					written ? " written to " : " (save with -t)",
+					written ? p_trace_file : "");
+		}
+		trace.started = false;
+		return (true);
+	}
+	return (false);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function prints one decoded record. 
+ *  @param type The record type code from the frame
+ *  @param p_data The record's bytes
+ *  @param length The number of bytes in the record
+ *  @return True if the record was recognized and was the right size
+ */
+
+static bool print_record (uint8_t type, const uint8_t* p_data, size_t length)
+{
+	if (type == TELEM_LOG)
+	{
+		return (print_log_records (p_data, length));
+	}
+	if (type == TELEM_TRACE)
+	{
+		return (collect_trace (p_data, length));
+	}
+	if (type == TELEM_DRIVE && length == sizeof (telem_drive_record))
+	{
+		telem_drive_record rec;
+		memcpy (&rec, p_data, sizeof (rec));
+		csv_header (type, "drive,time_us,motor_vel,servo_pos,cmd_age_us,pulse_width,"
+					"drive_state");
+		printf (csv_output ? "drive,%u,%d,%d,%u,%u,%u\n"
+				: "drive   t=%u us  motor=%d  servo=%d  cmd age=%u us  width=%u  "
+				  "state=%u\n",
+				rec.time_us, rec.motor_vel, rec.servo_pos, rec.cmd_age_us,
+				rec.pulse_width, rec.drive_state);
+		return (true);
+	}
+	if (type == TELEM_SYSTEM && length == sizeof (telem_system_record))
+	{
+		telem_system_record rec;
+		memcpy (&rec, p_data, sizeof (rec));
+		csv_header (type, "system,time_us,heap_free,frames_sent,deadline_misses");
+		printf (csv_output ? "system,%u,%u,%u,%u\n"
+				: "system  t=%u us  heap=%u  frames=%u  late=%u\n",
+				rec.time_us, rec.heap_free, rec.frames_sent, rec.deadline_misses);
+		return (true);
+	}
+	return (false);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function handles the bytes found between two zeros. If they make a frame 
+ *  with a good CRC, the record inside is printed; otherwise they are taken to be text
+ *  and copied to the standard error stream. 
+ *  @param p_chunk The bytes between the zeros
+ *  @param length The number of bytes
+ */
+
+static void handle_chunk (const uint8_t* p_chunk, size_t length)
+{
+	static int last_sequence = -1;
+	uint8_t frame[MAX_FRAME];
+	int frame_length = -1;
+
+	if (length == 0)
+	{
+		return;
+	}
+	if (length <= MAX_FRAME)
+	{
+		frame_length = cobs_decode (p_chunk, length, frame);
+	}
+
+	if (frame_length >= TELEM_OVERHEAD)
+	{
+		uint16_t crc = TELEM_CRC_INIT;
+		for (int index = 0; index < frame_length - 2; index++)
+		{
+			crc = crc16 (crc, frame[index]);
+		}
+		if (crc == ((frame[frame_length - 2] << 8) | frame[frame_length - 1])
+			&& print_record (frame[0], frame + 2, frame_length - TELEM_OVERHEAD))
+		{
+			if (last_sequence >= 0)
+			{
+				missed_frames += (uint8_t)(frame[1] - last_sequence - 1);
+			}
+			last_sequence = frame[1];
+			good_frames++;
+			fflush (stdout);
+			return;
+		}
+	}
+
+	// It isn't a good frame. Text from the console is expected; anything else is junk
+	bool is_text = true;
+	for (size_t index = 0; index < length; index++)
+	{
+		if (p_chunk[index] >= 0x80 
+			|| (p_chunk[index] < ' ' && strchr ("\r\n\t\f", p_chunk[index]) == NULL))
+		{
+			is_text = false;
+		}
+	}
+	if (is_text)
+	{
+		fwrite (p_chunk, 1, length, stderr);
+	}
+	else
+	{
+		bad_frames++;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function sets up a serial port for raw 8-bit input at the given baud rate.
+ *  @param fd The file descriptor of the open serial port
+ *  @param baud The baud rate, which must be one Linux knows
+ *  @return True if the port was set up, false if the baud rate isn't supported
+ */
+
+static bool set_up_port (int fd, long baud)
+{
+	static const struct { long rate; speed_t code; } rates[] =
+	{
+		{9600, B9600}, {19200, B19200}, {38400, B38400}, {57600, B57600}, 
+		{115200, B115200}, {230400, B230400}, {500000, B500000}, {1000000, B1000000}
+	};
+	struct termios settings;
+
+	for (size_t index = 0; index < sizeof (rates) / sizeof (rates[0]); index++)
+	{
+		if (rates[index].rate == baud && tcgetattr (fd, &settings) == 0)
+		{
+			cfmakeraw (&settings);
+			cfsetispeed (&settings, rates[index].code);
+			cfsetospeed (&settings, rates[index].code);
+			return (tcsetattr (fd, TCSANOW, &settings) == 0);
+		}
+	}
+	return (false);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** The main function reads the command line, opens the input, and decodes bytes 
+ *  until the input ends. A summary is printed on the standard error stream at the end.
+ */
+
+int main (int argc, char** argv)
+{
+	long baud = 0;
+	int opt;
+
+	while ((opt = getopt (argc, argv, "cb:l:t:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'c':
+				csv_output = true;
+				break;
+			case 'l':
+				p_log_table = read_file (optarg, &log_table_size);
+				if (p_log_table == NULL)
+				{
+					perror (optarg);
+					return (1);
+				}
+				break;
+			case 't':
+				p_trace_file = optarg;
+				break;
+			case 'b':
+				baud = atol (optarg);
+				break;
+			default:
+				fprintf (stderr, "Usage: %s [-c] [-b baud] [-l log table] "
+						 "[-t trace file] [device or file]\n", argv[0]);
+				return (1);
+		}
+	}
+
+	int fd = STDIN_FILENO;
+	if (optind < argc)
+	{
+		fd = open (argv[optind], O_RDONLY | O_NOCTTY);
+		if (fd < 0)
+		{
+			perror (argv[optind]);
+			return (1);
+		}
+	}
+	if (baud != 0 && isatty (fd) && !set_up_port (fd, baud))
+	{
+		fprintf (stderr, "Can't set serial port to %ld baud\n", baud);
+		return (1);
+	}
+
+	uint8_t chunk[MAX_CHUNK];
+	size_t length = 0;
+	uint8_t buffer[256];
+	ssize_t count;
+
+	while ((count = read (fd, buffer, sizeof (buffer))) > 0)
+	{
+		for (ssize_t index = 0; index < count; index++)
+		{
+			if (buffer[index] == 0)
+			{
+				handle_chunk (chunk, length);
+				length = 0;
+			}
+			else if (length < MAX_CHUNK)
+			{
+				chunk[length++] = buffer[index];
+			}
+			else
+			{
+				// Too long to be a frame; it must be text, so print what we have
+				handle_chunk (chunk, length);
+				chunk[0] = buffer[index];
+				length = 1;
+			}
+		}
+	}
+	handle_chunk (chunk, length);
+
+	fprintf (stderr, "\n%lu frames decoded, %lu bad, %lu missed\n", 
+			 good_frames, bad_frames, missed_frames);
+	return (0);
+}
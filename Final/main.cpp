@@ -8,6 +8,18 @@
  *    \li 11-29-2018 KM file created to setup the task state-machine.
  *    \li 12-4-2018 KM added all tasks to state machine.
  *    @li 12-9-2018 KM last planned edit.
+ *    @li 10-17-2026 KM car control task is woken by drive state and width updates.
+ *    @li 10-17-2026 KM pulse width is a sequence counted share, so the ISR won't wait.
+ *    @li 10-17-2026 KM motor and servo settings are one DriveCommand share.
+ *    @li 10-17-2026 KM user task is woken by the serial port and the print queue.
+ *    @li 10-17-2026 KM added the binary telemetry task.
+ *    @li 10-17-2026 KM added the deferred-format log queue.
+ *    @li 10-17-2026 KM tasks print through their own lines of a shared console.
+ *    @li 10-17-2026 KM debug and info text in the print queue is dropped, not awaited.
+ *    @li 10-17-2026 KM the Timer 3 capture ISR is timed by the profiler.
+ *    @li 10-17-2026 KM the Timer 3 capture ISR is marked in the RTOS trace.
+ *    @li 10-17-2026 KM telemetry task's stack size explained by its deepest path.
+ *    @li 10-17-2026 KM removed print queue drop policies, as no task writes to it.
  *
  *  License:
  *	This code is based on Prof. JR Ridgely's FreeRTOS CPP example code. The FreeRTOS
@@ -44,8 +56,12 @@
 #include "time_stamp.h"                     // Class to implement a microsecond timer
 #include "taskbase.h"                       // Header of wrapper for FreeRTOS tasks
 #include "textqueue.h"                      // Wrapper for FreeRTOS character queues
+#include "console.h"                        // Serial console shared by the tasks
+#include "profiler.h"                       // Times regions of code, if TASK_PROFILE
+#include "trace.h"                          // Records an RTOS trace, if TASK_TRACE
 #include "taskqueue.h"                      // Header of wrapper for FreeRTOS queues
 #include "taskshare.h"                      // Header for thread-safe shared data
+#include "seqshare.h"                       // Shared data with sequence counters
 #include "shares.h"                         // Global ('extern') queue declarations
 
 // Task includes
@@ -55,6 +71,10 @@
 #include "task_car_control.h"               // Header for car control task
 #include "task_radio.h"                     // Header for car control task
 #include "task_USR1.h"		                // Header for ultra sonic receiver task
+#include "task_telemetry.h"                 // Header for binary telemetry task
+
+// The telemetry port's baud rate must be one which the UART can make accurately
+UART_CHECK_BAUD (TELEMETRY_BAUD);
 
 
 
@@ -66,19 +86,19 @@
  */
 TextQueue* p_print_ser_queue;
 
-/** @brief A pointer to a variable that controls the servo position.
- *  @details p_motor_vel A pointer to an int8_t TaskShare variable that can control
- *  the position of the servo. This variable is set by the car control task and read
- *  by the servo task.
+/** @brief A queue of deferred-format log records.
+ *  @details p_log A pointer to a dlog_queue. Tasks log with the DLOG macros, which put
+ *  only an ID and the raw arguments into the queue; the telemetry task sends the
+ *  records to the PC, which formats them.
  */
-TaskShare<int8_t>* p_servo_pos;
+dlog_queue* p_log;
 
-/** @brief A pointer to a variable that controls the motor velocity.
- *  @details p_motor_vel A pointer to an int8_t TaskShare variable that can control
- *  the velocity of the motor. This variable is set by the car control task and read
- *  by the servo task.
+/** @brief A pointer to the command which sets the motor velocity and servo position.
+ *  @details p_drive_cmd A pointer to a SeqShare holding a DriveCommand. Both settings
+ *  are written together by the car control task and read by the motor and steering
+ *  tasks, so they always go together.
  */
-TaskShare<int8_t>* p_motor_vel;
+SeqShare<DriveCommand>* p_drive_cmd;
 
 /** @brief A pointer to a variable that represents the encoder ticks per second.
  *  @details p_enc_read A pointer to an int8_t TaskShare variable that represents
@@ -112,7 +132,10 @@ TaskShare<int8_t>* edge_1;
  *  of the encoder pulse for timing reporting. This variable is set in the encoder ISR.
  *  This feature is not fully implemented.
  */
-TaskShare<uint16_t>* width_1;
+SeqShare<uint16_t>* width_1;
+
+/// The number which marks the Timer 3 capture ISR in the RTOS trace.
+const uint8_t TRACE_CAPTURE_ISR = 0;
 
 
 //=====================================================================================
@@ -136,14 +159,18 @@ int main (void)
 	rs232* p_ser_port = new rs232 (9600, 1);
 	*p_ser_port << clrscr << PMS ("ME405 Lab 1 Starting Program") << endl;
 
+	// The tasks share the serial port through a console which sends each task's 
+	// lines whole, so lines printed by different tasks don't get mixed together.
+	// Lines from the control tasks are dropped rather than held up if it's busy
+	shared_console* p_console = new shared_console (p_ser_port);
+
 	// Create the queues and other shared data items here
 	p_print_ser_queue = new TextQueue (32, "Print", p_ser_port, 10);
+	p_log = new dlog_queue (LOG_QUEUE_SIZE);
 
-	// Create the shared servo position object (-90 degrees to 90 degrees)
-	p_servo_pos = new TaskShare<int8_t> ("Servo_Pos");
-
-	// Create the shared servo position object (-100 to 100)
-	p_motor_vel = new TaskShare<int8_t> ("Motor_Vel");
+	// Create the shared motor velocity (-100 to 100) and servo position (-90 degrees
+	// to 90 degrees) command
+	p_drive_cmd = new SeqShare<DriveCommand> ("Drive_Cmd");
 
 	// Create the shared encoder reading variable
 	p_enc_read = new TaskShare<int8_t> ("Encoder_read");
@@ -159,26 +186,54 @@ int main (void)
 	edge_1 = new TaskShare<int8_t> ("Edge1");
 
 	//Create shared USR1 pulse width
-	width_1 = new TaskShare<uint16_t> ("Width1");
+	width_1 = new SeqShare<uint16_t> ("Width1");
 
 	// The user interface is at low priority; it could have been run in the idle task
-	// but it is desired to exercise the RTOS more thoroughly in this test program
-	new task_user ("UserInt", task_priority (1), 260, p_ser_port);
+	// but it is desired to exercise the RTOS more thoroughly in this test program.
+	// It sleeps until a key is pressed or something is queued for printing
+	task_user* p_user_task
+		= new task_user ("UserInt", task_priority (1), 260, 
+						 new console_line (p_console));
+	p_ser_port->subscribe (p_user_task);
+	p_print_ser_queue->subscribe (p_user_task);
 
 	// Create a Task to control the steering of the car
-	new task_steering ("Steering", task_priority (5), 200, p_ser_port);
+	new task_steering ("Steering", task_priority (5), 200, 
+					   new console_line (p_console, CONSOLE_LINE_SIZE, true));
 
 	// Create a Task to control the motor
-	new task_motor ("Motor", task_priority (8), 200, p_ser_port);
+	new task_motor ("Motor", task_priority (8), 200, 
+					new console_line (p_console, CONSOLE_LINE_SIZE, true));
 
 	// Create a Task to control the RF transceiver
 	//new task_radio ("RF", task_priority (6), 200, p_ser_port);
 
-	//Create a Task to coordinate the other tasks
-	new task_car_control ("CarControl",task_priority (2), 200, p_ser_port);
+	//Create a Task to coordinate the other tasks. It sleeps until the drive state
+	//or the ultrasonic pulse width changes rather than polling them every tick
+	task_car_control* p_car_control
+		= new task_car_control ("CarControl",task_priority (2), 200, 
+								new console_line (p_console, CONSOLE_LINE_SIZE, true));
+	p_drive_state->subscribe (p_car_control);
+	width_1->subscribe (p_car_control);
 
 	//Create a Task to read ultrasonic receiver 1
-	new task_USR1 ("USR1",task_priority (7), 200, p_ser_port);
+	new task_USR1 ("USR1",task_priority (7), 200, 
+				   new console_line (p_console, CONSOLE_LINE_SIZE, true));
+
+	// Create a Task to send binary telemetry to a PC. It normally uses the second
+	// serial port so that the frames and the console text don't get mixed up; on
+	// the console, each frame is sent whole between other tasks' lines. Its deepest
+	// path is step() (about 50 bytes of records) calling trace_send() or the log
+	// queue's send(), then telemetry_link::send() and the port's write(), with an
+	// interrupt's saved context on top; the frame, encoding and payload buffers are
+	// kept in the link, log queue and trace recorder so they aren't on this stack
+	#ifdef TELEMETRY_ON_CONSOLE
+		emstream* p_telem_port = p_console;
+	#else
+		emstream* p_telem_port = new rs232 (TELEMETRY_BAUD, 0);
+	#endif
+	new task_telemetry ("Telemetry", task_priority (2), 260, 
+						new console_line (p_console), p_telem_port);
 	
 	//Create a Task to read ultrasonic receiver 2
 	//new task_USR2 ("USR2",task_priority (7), 200, p_ser_port);
@@ -189,6 +244,9 @@ int main (void)
 	//Create a Task to read motor hall efect sensor
 	//new task_HallEffect ("HallEffect",task_priority (9), 200, p_ser_port);
 
+	// Name the ISR's which are marked in the RTOS trace, if it's being recorded
+	trace_name_isr (TRACE_CAPTURE_ISR, "T3 capture");
+
 	// Here's where the RTOS scheduler is started up. It should never exit as long as
 	// power is on and the microcontroller isn't rebooted
 	sei(); // interrupts on
@@ -198,12 +256,18 @@ int main (void)
 }
 
 
+/// This profiled region measures how long the Timer 3 capture ISR takes to run.
+PROFILE_REGION (prof_capture_isr, "T3 capture ISR");
+
+
 /** @brief An ISR routine to determine the rotational velocity of the motor.
  *  @details This routine  is used to determine the rotational velocity of the motor.
  *  While it runs, it has not been fully implemented in our code.
  */
 ISR(TIMER3_CAPT_vect)
 {
+    TRACE_ISR_ENTER (TRACE_CAPTURE_ISR);
+    PROFILE_BEGIN (prof_capture_isr);
     uint16_t count1 = TCNT3;
 		//width_1->ISR_put(1);	//store value of pulse width
     if (edge_1->ISR_get ())	// rising edge
@@ -220,4 +284,6 @@ ISR(TIMER3_CAPT_vect)
 	    	width_1->ISR_put(count1);	//store value of pulse width
 				edge_1->ISR_put(1);		//Toggle edge_1 to 1
     }
+    PROFILE_END (prof_capture_isr);
+    TRACE_ISR_EXIT (TRACE_CAPTURE_ISR);
 }
@@ -6,6 +6,9 @@
  *  Revisions:
  *    @li 11-29-2018 KM file created to allow all tasks to access shared data.
  *    @li 12-9-2018 KM last planned edit.
+ *    @li 10-17-2026 KM pulse width is now a sequence counted share.
+ *    @li 10-17-2026 KM motor and servo settings are sent together as a DriveCommand.
+ *    @li 10-17-2026 KM added the deferred-format log queue.
  *
  *  License:
  *	This code is based on Prof. JR Ridgely's FreeRTOS CPP example code. The FreeRTOS
@@ -57,11 +60,40 @@
 // This queue allows tasks to send characters to the user interface task for display.
 extern TextQueue* p_print_ser_queue;
 
-// Motor velocity setting variable
-extern TaskShare<int8_t>* p_motor_vel;
-
-// Servo position setting variable
-extern TaskShare<int8_t>* p_servo_pos;
+// This queue holds deferred-format log records until the telemetry task sends them.
+class dlog_queue;
+extern dlog_queue* p_log;
+
+/** @brief A command for the motor and servo which is sent as one piece of data.
+ *  @details The car control task puts both settings into one of these along with the
+ *  time at which it was sent, so the motor and steering tasks never see a new speed
+ *  with an old steering angle and can tell how old the command is.
+ */
+struct DriveCommand
+{
+	/// Motor velocity setting (-100 to 100)
+	int8_t motor_vel;
+
+	/// Servo position setting (-90 degrees to 90 degrees)
+	int8_t servo_pos;
+
+	/// The time at which the command was sent
+	time_stamp issued;
+
+	/** @brief This method finds how long ago the command was sent.
+	 *  @return The age of the command in microseconds
+	 */
+	uint32_t age_us (void)
+	{
+		time_stamp age;
+		age.set_to_now ();
+		age -= issued;
+		return (age.get_seconds () * 1000000UL + age.get_microsec ());
+	}
+};
+
+// Motor velocity and servo position settings, written only by the car control task
+extern SeqShare<DriveCommand>* p_drive_cmd;
 
 // Encoder feedback variable
 extern TaskShare<int8_t>* p_enc_read;
@@ -75,7 +107,7 @@ extern TaskShare<uint8_t>* p_drive_state;
 //Rising or falling edge flag for ultrasonic sensor
 extern TaskShare<int8_t>* edge_1;
 
-//Pulse width for USR1
-extern TaskShare<uint16_t>* width_1;
+//Pulse width for USR1, written only by the input capture ISR after startup
+extern SeqShare<uint16_t>* width_1;
 
 #endif // _SHARES_H_
@@ -5,6 +5,7 @@
  *
  *  Revisions:
  *    @li 11-29-2018 AS created file for distance sensor operation
+ *    @li 10-17-2026 KM width share is cleared before the capture interrupt is enabled.
  *
  *  License:
  *	This code is based on Prof. JR Ridgely's FreeRTOS CPP example code. The FreeRTOS
@@ -89,14 +90,16 @@ void task_USR1::run (void)
 					TCCR3B = 0x00;
 					//Set to rising edge capture, 1024 prescaler set
 					TCCR3B |= (1 << ICES3) | (1<<CS32);
-					//Enable interrupts
-					TIMSK3 |= (1 << ICIE3);
-					//Clear input capture flag by writing a one
-					TIFR3 = (1 << ICF3);
-
+					//Initialize the shares before the ISR can use them;
+					//width_1 may only have one writer at a time
 					edge_1->put (1);
 					width_1->put (0);
 
+					//Clear input capture flag by writing a one
+					TIFR3 = (1 << ICF3);
+					//Enable interrupts
+					TIMSK3 |= (1 << ICIE3);
+
 					//Initialize Trigger pin
 					//Configure as output
 					DDRC |= (1 << PC1);
@@ -38,6 +38,7 @@
 #include "taskqueue.h"                      // Header of wrapper for FreeRTOS queues
 #include "textqueue.h"                      // Header for a "<<" queue class
 #include "taskshare.h"                      // Header for thread-safe shared data
+#include "seqshare.h"                       // Shared data with sequence counters
 
 #include "shares.h"                         // Global ('extern') queue declarations
 
@@ -5,6 +5,8 @@
  *  Revisions:
  *    @li 11-29-2018 KM file created to test the control of the car.
  *    @li 12-9-2018 KM last planned edit.
+ *    @li 10-17-2026 KM wait for share updates instead of polling every millisecond.
+ *    @li 10-17-2026 KM motor and servo settings are sent together as a DriveCommand.
  *
  */
 //**************************************************************************************
@@ -21,7 +23,8 @@
 
 //-------------------------------------------------------------------------------------
 /** This constructor creates a task to control the actions of the car. It is used to
- *  control the motor setpoint and the servo setpoint.
+ *  control the motor setpoint and the servo setpoint. Wakeups are enabled so that
+ *  shares this task subscribes to can wake it as soon as they are written.
  *  @param a_name A character string which will be the name of this task
  *  @param a_priority The priority at which this task will initially run (default: 0)
  *  @param a_stack_size The size of this task's stack in bytes
@@ -36,8 +39,8 @@ task_car_control::task_car_control (const char* a_name,
 					 )
 	: TaskBase (a_name, a_priority, a_stack_size, p_ser_dev)
 {
-	// Nothing is done in the body of this constructor. All the work is done in the
-	// call to the frt_task constructor on the line just above this one
+	// Let p_drive_state and width_1 wake this task up when they're written
+	enable_wakeups ();
 }
 
 
@@ -45,17 +48,20 @@ task_car_control::task_car_control (const char* a_name,
 /** @brief This method is called to actuate the motor and servo.
  *  @details This function works within the FreeRTOS framework. Once it is called, it 
  *  loops through a switch for as long as the main program is running in a finite state
- *  machine. This task uses the shared p_motor_vel and p_servo_pos variables calculate
- *  to get the car to move as desired.
+ *  machine. This task sends commands for the motor velocity and servo position through
+ *  the shared p_drive_cmd to get the car to move as desired.
  */
 
 void task_car_control::run (void)
 {
+	uint8_t state_before;                   // State at the top of each loop
 
 	// This is an infinite loop; it runs until the power is turned off. There is one
 	// such loop inside the code for each task
 	for (;;)
 	{
+		state_before = state;
+
 		// Run the finite state machine. The variable 'state' is kept by parent class
 		switch (state)
 		{
@@ -64,8 +70,7 @@ void task_car_control::run (void)
 			case (0):
 
 				// Set motor and servo to initial positions
-				p_motor_vel->put (0);
-				p_servo_pos->put (0);
+				send_command (0, 0);
 
 				state = 2;
 				break; // End of state 0
@@ -77,8 +82,7 @@ void task_car_control::run (void)
 				{
 					state = 2;
 				}
-				p_motor_vel->put (25);
-				p_servo_pos->put (0);
+				send_command (25, 0);
 				//*p_serial <<width_1->get () << endl;
 
 				break; // End of state 1
@@ -95,8 +99,7 @@ void task_car_control::run (void)
 					state = 3;
 				}
 
-				p_motor_vel->put (0);
-				p_servo_pos->put (90);
+				send_command (0, 90);
 
 				break; // End of state 2
 
@@ -108,16 +111,14 @@ void task_car_control::run (void)
 
 				else if ((width_1->get ()) < 150)
 				{
-					p_motor_vel->put (0);
-					p_servo_pos->put (90);
+					send_command (0, 90);
 					//*p_serial <<width_1->get () << endl;
 
 				}
 
 				else if ((width_1->get ()) > 150)
 				{
-					p_motor_vel->put (0);
-					p_servo_pos->put (0);
+					send_command (0, 0);
 				//	*p_serial <<width_1->get () << endl;
 				}
 				//*p_serial <<'1'<< endl;
@@ -134,8 +135,32 @@ void task_car_control::run (void)
 
 		runs++;                             // Increment counter for debugging
 
-		// No matter the state, wait for approximately a millisecond before we
-		// run the loop again. This gives lower priority tasks a chance to run
-		delay_ms (1);
+		// If the state just changed, run the new state right away. Otherwise sleep 
+		// until the drive state or pulse width is written or the timeout runs out
+		if (state == state_before)
+		{
+			wait_for_wakeup (((uint32_t)CAR_CONTROL_TIMEOUT_MS * configTICK_RATE_HZ)
+							 / 1000UL);
+		}
 	}
 }
+
+
+//-------------------------------------------------------------------------------------
+/** @brief This method sends a motor velocity and servo position in one command.
+ *  @details The two settings and the current time are put into a DriveCommand which is
+ *  written to p_drive_cmd all at once, so the motor and steering tasks always get a
+ *  velocity and position which were meant to go together.
+ *  @param motor_vel The motor velocity setting, from -100 to 100
+ *  @param servo_pos The servo position setting, from -90 to 90 degrees
+ */
+
+void task_car_control::send_command (int8_t motor_vel, int8_t servo_pos)
+{
+	DriveCommand command;
+
+	command.motor_vel = motor_vel;
+	command.servo_pos = servo_pos;
+	command.issued.set_to_now ();
+	p_drive_cmd->put (command);
+}
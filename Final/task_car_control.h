@@ -5,6 +5,8 @@
  *  Revisions:
  *    @li 11-29-2018 KM car control header created.
  *    @li 12-9-2018 KM last planned edit.
+ *    @li 10-17-2026 KM task sleeps until its input shares change.
+ *    @li 10-17-2026 KM motor and servo settings are sent together as a DriveCommand.
  *
  *  License:
  *	This code is based on Prof. JR Ridgely's FreeRTOS CPP example code. The FreeRTOS
@@ -43,10 +45,18 @@
 #include "taskqueue.h"                      // Header of wrapper for FreeRTOS queues
 #include "textqueue.h"                      // Header for a "<<" queue class
 #include "taskshare.h"                      // Header for thread-safe shared data
+#include "seqshare.h"                       // Shared data with sequence counters
 
 #include "shares.h"                         // Global ('extern') queue declarations
 
 
+/** @brief The longest time in milliseconds the car control task sleeps without input.
+ *  @details The task is woken whenever p_drive_state or width_1 is written; if neither
+ *  changes for this long, it runs anyway to refresh the motor and servo setpoints.
+ */
+#define CAR_CONTROL_TIMEOUT_MS 20
+
+
 
 /** @brief This task is used to control movement of the car.
  *  @details This task inherits the TaskBase class, and is used to run as a finite 
@@ -59,7 +69,8 @@ private:
 	// No private variables or methods for this class
 
 protected:
-	// protected method which calculates pwm duty cycle from servo angle
+	// Send a motor velocity and servo position to the motor and steering tasks
+	void send_command (int8_t motor_vel, int8_t servo_pos);
 
 public:
 	// This constructor creates a user interface task object
@@ -5,6 +5,10 @@
  *  Revisions:
  *    @li 11-29-2018 KM file created to test ESC.
  *    @li 12-9-2018 KM last planned edit.
+ *    @li 10-17-2026 KM runs as a PeriodicTask so its timing shows in the task list.
+ *    @li 10-17-2026 KM only writes the PWM register when the shared setting changes.
+ *    @li 10-17-2026 KM reads its setting from the DriveCommand share and times it.
+ *    @li 10-17-2026 KM calc_pwm() is timed by the profiler.
  *
  *  License:
  *	This code is based on Prof. JR Ridgely's FreeRTOS CPP example code. The FreeRTOS
@@ -30,6 +34,8 @@
 #include "task_motor.h"                     // Header for this file
 
 
+/// This profiled region measures how long calc_pwm() takes to run.
+PROFILE_REGION (prof_motor_pwm, "motor pwm");
 
 
 //-------------------------------------------------------------------------------------
@@ -47,92 +53,94 @@ task_motor::task_motor (const char* a_name,
 					  size_t a_stack_size,
 					  emstream* p_ser_dev
 					 )
-	: TaskBase (a_name, a_priority, a_stack_size, p_ser_dev)
+	: PeriodicTask (a_name, a_priority, a_stack_size, TASK_MOTOR_PERIOD_MS,
+					p_ser_dev)
 {
-	// Nothing is done in the body of this constructor. All the work is done in the
-	// call to the frt_task constructor on the line just above this one
+	offset = -2;
+	max_cmd_age_us = 0;
 }
 
 
 //-------------------------------------------------------------------------------------
-/** @brief This method is called to run the motor control loop.
- *  @details This function works within the FreeRTOS framework. Once it is called, it 
- *  loops through a switch for as long as the main program is running in a finite state
- *  machine. This task uses the shared p_motor_vel variable calculate and set the
- *  PWM signal which activates the motor controller.
+/** @brief This method is called to run one pass of the motor control loop.
+ *  @details This function works within the FreeRTOS framework. It is called by the
+ *  PeriodicTask parent class once every TASK_MOTOR_PERIOD_MS milliseconds and runs
+ *  one pass through the finite state machine. This task uses the shared p_drive_cmd
+ *  command to calculate and set the PWM signal which activates the motor controller.
+ *  The PWM register is only written when a new command has been sent.
  */
 
-void task_motor::run (void)
+void task_motor::step (void)
 {
+	DriveCommand command;                   // Newest command from car control
 
-	offset = -2;
-
-	// This is an infinite loop; it runs until the power is turned off. There is one
-	// such loop inside the code for each task
-	for (;;)
+	// Run the finite state machine. The variable 'state' is kept by parent class
+	switch (state)
 	{
-		// Run the finite state machine. The variable 'state' is kept by parent class
-		switch (state)
-		{
-			// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-			// In state 0, setup the output pin for the motor on PB5(OC1A)
-			case (0):
-				// Need a wave with period ~ 20 ms and pulse length of 1.0-2.0 ms
-				// f = f_clk / N*(1 + TOP)
-				// Want f = 50 [hz]
-				// TOP = 0xFF = 255, f_clk = 16 [Mhz]
-				// N = 1024 ---> f = 61.3 [hz] close enough
-				
-
-				// Set PB5 as output pin
-				DDRB |= (1 << PB5);
-				// Setup register for fast pwm, non-inverting
-				// WGM: fast pwm 0x03FF/1023    COM1A1: non-inverting output
-				TCCR1A |= (1 << WGM11) | (1 << COM1A1);
-				// WGM: fast pwm 0x03FF     CS: prescaler = 256
-				TCCR1B |= (1 << WGM12) | (1 << WGM13) | (1 << CS12);
-				// TCCR1C unused
-
-				// ICR = 0xFFFF counts to this value
-				ICR1H = 0x04;
-				ICR1L = 0xE1;
-
-				// Setup of OCR
-				// 1.5 [ms] ----> 667 [hz] ---> 94
-				// Should run 50.0 [hz] period with 1.5 [ms] pulses
-				OCR1AH = 0x00;
-				OCR1AL = 0x5E;
-
-				// Move to control state
-				state = 1;
-				break; // End of state 0
-
-			// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-			// In state 1, control the esc power
-			case (1):
-				// Vary OCR to change pulse length.
-				// Pulses are between 1.0 and 2.0 [ms]
-
-				OCR1AL = calc_pwm(p_motor_vel->get ());
-
-				break; // End of state 1
-
-			// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-			// We should never get to the default state. If we do, complain and restart
-			default:
-				*p_serial << PMS ("Illegal state! Resetting AVR") << endl;
-				wdt_enable (WDTO_120MS);
-				for (;;) ;
-				break;
-
-		} // End switch state
-
-		runs++;                             // Increment counter for debugging
-
-		// No matter the state, wait for approximately a millisecond before we
-		// run the loop again. This gives lower priority tasks a chance to run
-		delay_ms (1);
-	}
+		// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		// In state 0, setup the output pin for the motor on PB5(OC1A)
+		case (0):
+			// Need a wave with period ~ 20 ms and pulse length of 1.0-2.0 ms
+			// f = f_clk / N*(1 + TOP)
+			// Want f = 50 [hz]
+			// TOP = 0xFF = 255, f_clk = 16 [Mhz]
+			// N = 1024 ---> f = 61.3 [hz] close enough
+			
+
+			// Set PB5 as output pin
+			DDRB |= (1 << PB5);
+			// Setup register for fast pwm, non-inverting
+			// WGM: fast pwm 0x03FF/1023    COM1A1: non-inverting output
+			TCCR1A |= (1 << WGM11) | (1 << COM1A1);
+			// WGM: fast pwm 0x03FF     CS: prescaler = 256
+			TCCR1B |= (1 << WGM12) | (1 << WGM13) | (1 << CS12);
+			// TCCR1C unused
+
+			// ICR = 0xFFFF counts to this value
+			ICR1H = 0x04;
+			ICR1L = 0xE1;
+
+			// Setup of OCR
+			// 1.5 [ms] ----> 667 [hz] ---> 94
+			// Should run 50.0 [hz] period with 1.5 [ms] pulses
+			OCR1AH = 0x00;
+			OCR1AL = 0x5E;
+
+			// Apply commands sent from now on; until one comes, the PWM stays neutral
+			cmd_version = p_drive_cmd->get_version ();
+
+			// Move to control state
+			state = 1;
+			break; // End of state 0
+
+		// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		// In state 1, control the esc power
+		case (1):
+			// Vary OCR to change pulse length.
+			// Pulses are between 1.0 and 2.0 [ms]. Only recompute the pulse length
+			// when a new command has been put into the share
+			if (p_drive_cmd->get_if_changed (command, cmd_version))
+			{
+				OCR1AL = calc_pwm (command.motor_vel);
+
+				uint32_t age_us = command.age_us ();
+				if (age_us > max_cmd_age_us)
+				{
+					max_cmd_age_us = age_us;
+				}
+			}
+
+			break; // End of state 1
+
+		// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		// We should never get to the default state. If we do, complain and restart
+		default:
+			*p_serial << PMS ("Illegal state! Resetting AVR") << endl;
+			wdt_enable (WDTO_120MS);
+			for (;;) ;
+			break;
+
+	} // End switch state
 }
 
 
@@ -149,6 +157,8 @@ void task_motor::run (void)
 
 uint8_t task_motor::calc_pwm (int8_t pwm)
 {
+	PROFILE_SCOPE (prof_motor_pwm);
+
 	// Make sure input is between -90 and 90 degrees
 	if (pwm < -100)
 	{
@@ -160,3 +170,19 @@ uint8_t task_motor::calc_pwm (int8_t pwm)
 	// Convert degrees to pulse length (64-124)
 	return (uint8_t) (offset + 94 + (pwm * 0.3));
 }
+
+
+//-------------------------------------------------------------------------------------
+/** @brief This method prints the status of the motor task.
+ *  @details The usual periodic task status is printed, followed by the age of the
+ *  oldest drive command which this task has applied, which is how long a command
+ *  can take to get from the car control task to the motor.
+ *  @param ser_dev A reference to the serial device to which to print the status
+ */
+
+void task_motor::print_status (emstream& ser_dev)
+{
+	PeriodicTask::print_status (ser_dev);
+
+	ser_dev << PMS ("\tcmd age: ") << max_cmd_age_us << PMS (" us");
+}
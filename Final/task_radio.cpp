@@ -5,6 +5,9 @@
  *  Revisions:
  *    @li 12-1-2018 KM file created to operate the transciever.
  *    @li 12-9-2018 KM last planned edit.
+ *    @li 10-17-2026 KM radio status is logged with DLOG rather than printed.
+ *    @li 10-17-2026 KM transmit() is timed by the profiler.
+ *    @li 10-17-2026 KM millisecond waits sleep in delay_us() rather than busy-waiting.
  *  
  *  License:
  *	This code is based on Prof. JR Ridgely's FreeRTOS CPP example code. The FreeRTOS
@@ -31,8 +34,8 @@
 #include "task_radio.h"                     // Header for this file
 
 
-
-
+/// This profiled region measures how long transmit() takes to send a packet.
+PROFILE_REGION (prof_radio_tx, "nrf24 tx");
 
 
 //-------------------------------------------------------------------------------------
@@ -80,7 +83,7 @@ void task_radio::run (void)
 				
 				init_spi ();
 				_delay_us (10);
-				*p_serial << get_reg(STATUS) << endl;
+				DLOG1 (p_log, "radio set up, status 0x%02x", get_reg (STATUS));
 				//write_byte (R_REGISTER + STATUS);
 				
 				state = 1;
@@ -99,7 +102,7 @@ void task_radio::run (void)
 				
 			case (2):
 				// Send ping signal
-				*p_serial << get_reg(STATUS) << endl;
+				DLOG1 (p_log, "radio ping, status 0x%02x", get_reg (STATUS));
 				
 				uint8_t name [5];
 				name[0] = 'n';
@@ -116,7 +119,7 @@ void task_radio::run (void)
 				val[0] = 0b00000010;
 				read_or_write (W, CONFIG, val, 1);
 				
-				_delay_ms(2);
+				delay_us (2000);
 				
 				// Send message
 				uint8_t data[2];
@@ -272,13 +275,15 @@ uint8_t *task_radio::read_or_write (uint8_t ReadWrite, uint8_t reg, uint8_t *val
   */
 void task_radio::transmit (uint8_t *W_buff)
 {
+	PROFILE_SCOPE (prof_radio_tx);
+
 	read_or_write (R, FLUSH_TX, W_buff, 0);
 	read_or_write (R, W_TX_PAYLOAD, W_buff, 2);
 	
-	_delay_ms(10);
+	delay_us (10000);
 	// Set CE high
 	PORTE |= (1 << PE3);
-	_delay_ms(10);
+	delay_us (10000);
 	// Set CE low
 	PORTE &= ~(1 << PE3);
 }
@@ -5,6 +5,8 @@
  *  Revisions:
  *    @li 11-29-2018 KM header for RF transciever task.
  *    @li 12-9-2018 KM last planned edit.
+ *    @li 10-17-2026 KM includes the deferred-format logging header.
+ *    @li 10-17-2026 KM includes the profiler header.
  *
  *  License:
  *	This code is based on Prof. JR Ridgely's FreeRTOS CPP example code. The FreeRTOS
@@ -39,10 +41,13 @@
 // ME 507 library includes
 #include "rs232int.h"                       // ME405/507 library for serial comm.
 #include "time_stamp.h"                     // Class to implement a microsecond timer
+#include "profiler.h"                       // Times regions of code, if TASK_PROFILE
 #include "taskbase.h"                       // Header for ME405/507 base task class
 #include "taskqueue.h"                      // Header of wrapper for FreeRTOS queues
 #include "textqueue.h"                      // Header for a "<<" queue class
 #include "taskshare.h"                      // Header for thread-safe shared data
+#include "seqshare.h"                       // Shared data with sequence counters
+#include "dlog.h"                           // Deferred-format logging
 
 
 
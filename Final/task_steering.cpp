@@ -6,6 +6,9 @@
  *  Revisions:
  *    @li 11-29-2018 KM file created to test steering servo.
  *    @li 12-4-2018 KM last planned edit.
+ *    @li 10-17-2026 KM only writes the PWM register when the shared setting changes.
+ *    @li 10-17-2026 KM reads its setting from the DriveCommand share and times it.
+ *    @li 10-17-2026 KM calc_pwm() is timed by the profiler.
  *  
  *  License:
  *	This code is based on Prof. JR Ridgely's FreeRTOS CPP example code. The FreeRTOS
@@ -31,6 +34,8 @@
 #include "task_steering.h"                      // Header for this file
 
 
+/// This profiled region measures how long calc_pwm() takes to run.
+PROFILE_REGION (prof_steer_pwm, "steer pwm");
 
 
 //-------------------------------------------------------------------------------------
@@ -48,81 +53,86 @@ task_steering::task_steering (const char* a_name,
 					  size_t a_stack_size,
 					  emstream* p_ser_dev
 					 )
-	: TaskBase (a_name, a_priority, a_stack_size, p_ser_dev)
+	: PeriodicTask (a_name, a_priority, a_stack_size, TASK_STEERING_PERIOD_MS,
+					p_ser_dev)
 {
-	// Nothing is done in the body of this constructor. All the work is done in the
-	// call to the frt_task constructor on the line just above this one
+	// Nothing has been applied yet, so no command has been seen to be old
+	max_cmd_age_us = 0;
 }
 
 
 //-------------------------------------------------------------------------------------
-/** @brief This method is called to run the servo control loop.
- *  @details This function works within the FreeRTOS framework. Once it is called, it 
- *  loops through a switch for as long as the main program is running in a finite state
- *  machine. This task uses the shared p_servo_pos variable calculate and set the
- *  PWM signal which activates the servo.
+/** @brief This method is called to run one pass of the servo control loop.
+ *  @details This function works within the FreeRTOS framework. It is called by the
+ *  PeriodicTask parent class once every TASK_STEERING_PERIOD_MS milliseconds and runs
+ *  one pass through the finite state machine. This task uses the shared p_drive_cmd
+ *  command to calculate and set the PWM signal which activates the servo. The PWM
+ *  register is only written when a new command has been sent.
  */
 
-void task_steering::run (void)
+void task_steering::step (void)
 {
+	DriveCommand command;                   // Newest command from car control
 
-	// This is an infinite loop; it runs until the power is turned off. There is one 
-	// such loop inside the code for each task
-	for (;;)
+	// Run the finite state machine. The variable 'state' is kept by parent class
+	switch (state)
 	{
-		// Run the finite state machine. The variable 'state' is kept by parent class
-		switch (state)
-		{
-			// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-			// In state 0, setup the output pin for the servo on PB4(OC2A)
-			case (0):
-				// Need a wave with period ~ 20 ms and pulse length of 1.0-2.0 ms
-				// f = f_clk / N*(1 + TOP)
-				// Want f = 50 [hz]
-				// TOP = 0xFF = 255, f_clk = 16 [Mhz]
-				// N = 1024 ---> f = 61.3 [hz] close enough
-				
-				// Set PB4 as output pin
-				DDRB |= (1 << PB4);
-				// Setup timer register for fast pwm, non-inverting
-				// WGM: fast pwm     COM: non-inverting output
-				TCCR2A |= (1 << WGM20) | (1 << WGM21) | (1 << COM2A1);
-				// WGM: fast pwm     CS: prescaler = 1024
-				TCCR2B |= (1 << CS22) | (1 << CS21) | (1 << CS20);
-
-				// Setup of OCR
-				// 1.5 [ms] ----> 667 [hz] ---> 24
-				// Should run 61.3 [hz] period with 1.5 [ms] pulses
-				OCR2A = 24;
-				
-				state = 1;
-				break; // End of state 0
-
-			// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-			// In state 1, control the servo position
-			case (1):
-				// Vary OCR to change pulse length.
-				// Pulses are between 1.0 and 2.0 [ms]
-				OCR2A = calc_pwm(p_servo_pos->get ());
-				
-				break; // End of state 1
-
-			// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-			// We should never get to the default state. If we do, complain and restart
-			default:
-				*p_serial << PMS ("Illegal state! Resetting AVR") << endl;
-				wdt_enable (WDTO_120MS);
-				for (;;) ;
-				break;
-
-		} // End switch state
-
-		runs++;                             // Increment counter for debugging
-
-		// No matter the state, wait for approximately a millisecond before we 
-		// run the loop again. This gives lower priority tasks a chance to run
-		delay_ms (1);
-	}
+		// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		// In state 0, setup the output pin for the servo on PB4(OC2A)
+		case (0):
+			// Need a wave with period ~ 20 ms and pulse length of 1.0-2.0 ms
+			// f = f_clk / N*(1 + TOP)
+			// Want f = 50 [hz]
+			// TOP = 0xFF = 255, f_clk = 16 [Mhz]
+			// N = 1024 ---> f = 61.3 [hz] close enough
+			
+			// Set PB4 as output pin
+			DDRB |= (1 << PB4);
+			// Setup timer register for fast pwm, non-inverting
+			// WGM: fast pwm     COM: non-inverting output
+			TCCR2A |= (1 << WGM20) | (1 << WGM21) | (1 << COM2A1);
+			// WGM: fast pwm     CS: prescaler = 1024
+			TCCR2B |= (1 << CS22) | (1 << CS21) | (1 << CS20);
+
+			// Setup of OCR
+			// 1.5 [ms] ----> 667 [hz] ---> 24
+			// Should run 61.3 [hz] period with 1.5 [ms] pulses
+			OCR2A = 24;
+
+			// Apply commands sent from now on; until one comes, the PWM stays neutral
+			cmd_version = p_drive_cmd->get_version ();
+
+			state = 1;
+			break; // End of state 0
+
+		// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		// In state 1, control the servo position
+		case (1):
+			// Vary OCR to change pulse length.
+			// Pulses are between 1.0 and 2.0 [ms]. Only recompute the pulse length
+			// when a new command has been put into the share
+			if (p_drive_cmd->get_if_changed (command, cmd_version))
+			{
+				OCR2A = calc_pwm (command.servo_pos);
+
+				uint32_t age_us = command.age_us ();
+				if (age_us > max_cmd_age_us)
+				{
+					max_cmd_age_us = age_us;
+				}
+			}
+			
+			break; // End of state 1
+
+		// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		// We should never get to the default state. If we do, complain and restart
+		default:
+			*p_serial << PMS ("Illegal state! Resetting AVR") << endl;
+			wdt_enable (WDTO_120MS);
+			for (;;) ;
+			break;
+
+	} // End switch state
 }
 
 //-------------------------------------------------------------------------------------
@@ -135,6 +145,8 @@ void task_steering::run (void)
  */
 uint8_t task_steering::calc_pwm (int8_t pwm)
 {
+	PROFILE_SCOPE (prof_steer_pwm);
+
 	// Make sure input is between -90 and 90 degrees
 	if (pwm < -90)
 	{
@@ -145,4 +157,20 @@ uint8_t task_steering::calc_pwm (int8_t pwm)
 	
 	// Convert degrees to pulse length (16-31)
 	return (uint8_t) (24 + (pwm * 0.077));
-}
\ No newline at end of file
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief This method prints the status of the steering task.
+ *  @details The usual periodic task status is printed, followed by the age of the
+ *  oldest drive command which this task has applied, which is how long a command
+ *  can take to get from the car control task to the servo.
+ *  @param ser_dev A reference to the serial device to which to print the status
+ */
+
+void task_steering::print_status (emstream& ser_dev)
+{
+	PeriodicTask::print_status (ser_dev);
+
+	ser_dev << PMS ("\tcmd age: ") << max_cmd_age_us << PMS (" us");
+}
@@ -5,6 +5,10 @@
  *  Revisions:
  *    @li 11-29-2018 KM header for steering task created.
  *    @li 12-9-2018 KM last planned edit.
+ *    @li 10-17-2026 KM runs as a PeriodicTask so its timing shows in the task list.
+ *    @li 10-17-2026 KM only writes the PWM register when the shared setting changes.
+ *    @li 10-17-2026 KM reads its setting from the DriveCommand share and times it.
+ *    @li 10-17-2026 KM includes the profiler header.
  *
  *  License:
  *	This code is based on Prof. JR Ridgely's FreeRTOS CPP example code. The FreeRTOS
@@ -39,20 +43,27 @@
 // ME 507 library includes
 #include "rs232int.h"                       // ME405/507 library for serial comm.
 #include "time_stamp.h"                     // Class to implement a microsecond timer
+#include "profiler.h"                       // Times regions of code, if TASK_PROFILE
 #include "taskbase.h"                       // Header for ME405/507 base task class
+#include "periodictask.h"                   // Header for tasks run at a fixed period
 #include "taskqueue.h"                      // Header of wrapper for FreeRTOS queues
 #include "textqueue.h"                      // Header for a "<<" queue class
 #include "taskshare.h"                      // Header for thread-safe shared data
+#include "seqshare.h"                       // Shared data with sequence counters
 
 #include "shares.h"                         // Global ('extern') queue declarations
 
 
+/// The period at which the steering task updates its PWM output, in milliseconds.
+#define TASK_STEERING_PERIOD_MS 1
+
+
 /** @brief This task is used to control the position of the servo.
- *  @details This task inherits the TaskBase class, and is used to run as a finite 
+ *  @details This task inherits the PeriodicTask class, and is used to run as a finite 
  *   state machine. It controls the actions of the servo using a timer for PWM.
  */
 
-class task_steering : public TaskBase
+class task_steering : public PeriodicTask
 {
 private:
 	// No private variables or methods for this class
@@ -61,11 +72,20 @@ protected:
 	// protected method which calculates pwm duty cycle from servo angle
 	uint8_t calc_pwm (int8_t);
 
+	/// The version of the drive command which was last written to the PWM.
+	share_version_t cmd_version;
+
+	/// The age of the oldest drive command applied so far, in microseconds.
+	uint32_t max_cmd_age_us;
+
 public:
 	task_steering (const char*, unsigned portBASE_TYPE, size_t, emstream*);
 
-	/// This method is called by the RTOS once to run the task loop for ever and ever.
-	void run (void);
+	/// This method is called once every TASK_STEERING_PERIOD_MS milliseconds.
+	void step (void);
+
+	// This method prints the task's status, including the drive command age
+	void print_status (emstream&);
 };
 
 #endif // _TASK_STEERING_H_
@@ -0,0 +1,109 @@
+//**************************************************************************************
+/** @file task_telemetry.cpp
+ *    This file contains code to send binary telemetry from our ME 507 term project car
+ *    to a PC, where host/telem_decode turns it back into numbers.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 KM file created for the binary telemetry link.
+ *    @li 10-17-2026 KM sends the records queued by DLOG statements.
+ *    @li 10-17-2026 KM sends the RTOS trace when it has been frozen.
+ *  
+ *  License:
+ *	This code is based on Prof. JR Ridgely's FreeRTOS CPP example code. The FreeRTOS
+ *	framework is used, but the tasks are a product of our 507 group. Since the original
+ *	code used the LGPL, our code will also use the LGPL.
+ *		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * 		IMPLIED 	WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * 		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * 		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ * 		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * 		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * 		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * 		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * 		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+
+#include "task_telemetry.h"                 // Header for this file
+
+
+//-------------------------------------------------------------------------------------
+/** This constructor creates a task which sends telemetry records to a PC.
+ *  @param a_name A character string which will be the name of this task
+ *  @param a_priority The priority at which this task will initially run
+ *  @param a_stack_size The size of this task's stack in bytes
+ *  @param p_ser_dev A pointer to the serial port which writes debugging info
+ *  @param p_telem_dev A pointer to the serial port through which telemetry is sent; 
+ *                     this may be the same port as the console
+ */
+
+task_telemetry::task_telemetry (const char* a_name, 
+					  unsigned portBASE_TYPE a_priority, 
+					  size_t a_stack_size,
+					  emstream* p_ser_dev,
+					  emstream* p_telem_dev
+					 )
+	: PeriodicTask (a_name, a_priority, a_stack_size, TASK_TELEMETRY_PERIOD_MS,
+					p_ser_dev),
+	  link (p_telem_dev)
+{
+	// Send a system record right away so the PC knows the program has started
+	system_countdown = 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief This method is called to send one period's telemetry.
+ *  @details A drive record is filled in from the shared data and sent every period.
+ *  Every TELEM_SYSTEM_EVERY periods a system record is sent as well, and then any 
+ *  log records waiting in the log queue are sent. If the RTOS trace has been frozen,
+ *  it's sent too. No text is formatted; the PC does that.
+ */
+
+void task_telemetry::step (void)
+{
+	time_stamp now;                         // The time the records are taken
+	DriveCommand command;                   // The newest command from car control
+	telem_drive_record drive;               // Record of the car's drive state
+	telem_system_record health;             // Record of the program's health
+
+	now.set_to_now ();
+	drive.time_us = now.get_seconds () * 1000000UL + now.get_microsec ();
+
+	// The drive command share holds garbage until car control sends its first command
+	if (p_drive_cmd->get_writes () != 0)
+	{
+		command = p_drive_cmd->get ();
+		drive.motor_vel = command.motor_vel;
+		drive.servo_pos = command.servo_pos;
+		drive.cmd_age_us = command.age_us ();
+	}
+	else
+	{
+		drive.motor_vel = 0;
+		drive.servo_pos = 0;
+		drive.cmd_age_us = 0;
+	}
+	drive.pulse_width = width_1->get ();
+	drive.drive_state = p_drive_state->get ();
+	link.send (TELEM_DRIVE, drive);
+
+	if (system_countdown == 0)
+	{
+		system_countdown = TELEM_SYSTEM_EVERY;
+
+		health.time_us = drive.time_us;
+		health.heap_free = heap_left ();
+		health.frames_sent = link.get_frames_sent ();
+		health.deadline_misses = get_deadline_misses ();
+		link.send (TELEM_SYSTEM, health);
+	}
+	system_countdown--;
+
+	// Send any log records which other tasks have queued
+	p_log->send (&link);
+
+	// Send the RTOS trace if the user has frozen it
+	trace_send (&link);
+}
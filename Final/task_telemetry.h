@@ -0,0 +1,101 @@
+//**************************************************************************************
+/** @file task_telemetry.h
+ *    This file contains header contents for the telemetry task.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 KM header for binary telemetry task created.
+ *    @li 10-17-2026 KM the task also sends queued log records.
+ *    @li 10-17-2026 KM the task also sends the RTOS trace.
+ *
+ *  License:
+ *	This code is based on Prof. JR Ridgely's FreeRTOS CPP example code. The FreeRTOS
+ *	framework is used, but the tasks are a product of our 507 group. Since the original
+ *	code used the LGPL, our code will also use the LGPL.
+ *		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * 		IMPLIED 	WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * 		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * 		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ * 		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * 		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * 		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * 		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * 		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _TASK_TELEMETRY_H_
+#define _TASK_TELEMETRY_H_
+
+#include <stdlib.h>                         // Prototype declarations for I/O functions
+
+
+// FreeRTOS library includes
+#include "FreeRTOS.h"                       // Primary header for FreeRTOS
+#include "task.h"                           // Header for FreeRTOS task functions
+
+
+// ME 507 library includes
+#include "rs232int.h"                       // ME405/507 library for serial comm.
+#include "time_stamp.h"                     // Class to implement a microsecond timer
+#include "taskbase.h"                       // Header for ME405/507 base task class
+#include "periodictask.h"                   // Header for tasks run at a fixed period
+#include "textqueue.h"                      // Header for a "<<" queue class
+#include "taskshare.h"                      // Header for thread-safe shared data
+#include "seqshare.h"                       // Shared data with sequence counters
+#include "telemetry.h"                      // COBS framed binary telemetry
+#include "dlog.h"                           // Deferred-format logging
+#include "trace.h"                          // Records an RTOS trace, if TASK_TRACE
+
+#include "shares.h"                         // Global ('extern') queue declarations
+#include "telemetry_records.h"              // Layout of the records which are sent
+
+
+/// The period at which the telemetry task sends a drive record, in milliseconds.
+#define TASK_TELEMETRY_PERIOD_MS 50
+
+/// The number of telemetry periods between system records.
+#define TELEM_SYSTEM_EVERY 20
+
+/** @brief The baud rate of the second serial port, which carries the telemetry.
+ *  @details 500000 baud is exact with a 16 MHz clock and is a standard rate for Linux
+ *  serial ports. If TELEMETRY_ON_CONSOLE is defined in the Makefile, telemetry is sent
+ *  through the console port at the console's baud rate instead.
+ */
+#define TELEMETRY_BAUD 500000UL
+
+/** @brief The number of bytes in the log queue.
+ *  @details Each log record takes three bytes plus its arguments, and the queue is 
+ *  emptied every telemetry period; records logged when it's full are lost.
+ */
+#define LOG_QUEUE_SIZE 128
+
+
+/** @brief This task sends the car's state to a PC as binary telemetry records.
+ *  @details This task inherits the PeriodicTask class. Each period it copies the drive
+ *   command, drive state, and ultrasonic pulse width into a record and sends it as a
+ *   COBS frame through a telemetry_link; every so often it also sends a record of 
+ *   system health. The records are decoded on the PC by host/telem_decode. 
+ */
+
+class task_telemetry : public PeriodicTask
+{
+private:
+	// No private variables or methods for this class
+
+protected:
+	/// The link which frames the records and sends them out the telemetry port.
+	telemetry_link link;
+
+	/// The number of periods until the next system record is sent.
+	uint8_t system_countdown;
+
+public:
+	task_telemetry (const char*, unsigned portBASE_TYPE, size_t, emstream*, emstream*);
+
+	/// This method is called once every TASK_TELEMETRY_PERIOD_MS milliseconds.
+	void step (void);
+};
+
+#endif // _TASK_TELEMETRY_H_
@@ -7,6 +7,12 @@
  *  Revisions:
  *    @li 11-29-2018 KM header user control task created.
  *    @li 12-9-2018 KM last planned edit.
+ *    @li 10-17-2026 KM prints whole spans of text from the print queue at once.
+ *    @li 10-17-2026 KM sleeps until a key is pressed or text is queued for printing.
+ *    @li 10-17-2026 KM prints through a console line, sent before the task sleeps.
+ *    @li 10-17-2026 KM the 'P' command prints the profiler's table.
+ *    @li 10-17-2026 KM the 'T' command freezes the RTOS trace so it's sent to the PC.
+ *    @li 10-17-2026 KM the 'j' command checks how late delay_us() delays end.
  *
  *  License:
  *	This code is based on Prof. JR Ridgely's FreeRTOS CPP example code. The FreeRTOS
@@ -35,6 +41,10 @@
  */
 const TickType_t ticks_to_delay = ((configTICK_RATE_HZ / 1000) * 5);
 
+/** This constant sets how many times each length of delay is timed by the 'j' command.
+ */
+const uint8_t DELAY_TRIALS = 20;
+
 
 //-------------------------------------------------------------------------------------
 /** This constructor creates a new data acquisition task. Its main job is to call the
@@ -54,8 +64,8 @@ task_user::task_user (const char* a_name,
 					 )
 	: TaskBase (a_name, a_priority, a_stack_size, p_ser_dev)
 {
-	// Nothing is done in the body of this constructor. All the work is done in the
-	// call to the frt_task constructor on the line just above this one
+	// Let the serial port and the print queue wake this task when there's input
+	enable_wakeups ();
 }
 
 
@@ -121,6 +131,27 @@ void task_user::run (void)
 							show_status ();
 							break;
 
+						// The 'P' command prints how long profiled code regions take
+						case ('P'):
+							print_all_profiles (p_serial);
+							break;
+
+						// The 'T' command freezes the RTOS trace; the telemetry task
+						// then sends it to the PC, which makes it into a timeline
+						case ('T'):
+							#ifdef TASK_TRACE
+								trace_freeze ();
+								*p_serial << PMS ("Trace frozen, sending") << endl;
+							#else
+								*p_serial << PMS ("Trace needs -DTASK_TRACE") << endl;
+							#endif
+							break;
+
+						// The 'j' command checks the timing of microsecond delays
+						case ('j'):
+							check_delay_us ();
+							break;
+
 						// The 'd' command has all the tasks dump their stacks
 						case ('d'):
 							print_task_stacks (p_serial);
@@ -200,7 +231,10 @@ void task_user::run (void)
 				// something to be printed
 				else if (p_print_ser_queue->check_for_char ())
 				{
-					p_serial->putchar (p_print_ser_queue->getchar ());
+					const char* p_text;
+					uint16_t length = p_print_ser_queue->get_span (p_text);
+					p_serial->write (p_text, length);
+					p_print_ser_queue->consume (length);
 				}
 
 				break; // End of state 1
@@ -217,9 +251,21 @@ void task_user::run (void)
 
 		runs++;                             // Increment counter for debugging
 
-		// No matter the state, wait for approximately a millisecond before we
-		// run the loop again. This gives lower priority tasks a chance to run
-		delay_ms (1);
+		// Send any partly printed line, such as echoed digits, before going to sleep
+		p_serial->transmit_now ();
+
+		// Unless there's more to do right away, sleep until a character is typed or 
+		// (in state 1, where the print queue is emptied) text is queued for printing
+		if (p_serial->check_for_char ()
+			|| (state == 1 && p_print_ser_queue->check_for_char ()))
+		{
+			delay_ms (1);
+		}
+		else
+		{
+			wait_for_wakeup (((uint32_t)USER_IDLE_TIMEOUT_MS * configTICK_RATE_HZ)
+							 / 1000UL);
+		}
 	}
 }
 
@@ -238,6 +284,9 @@ void task_user::print_help_message (void)
 	*p_serial << PMS ("  t:     Show the time right now") << endl;
 	*p_serial << PMS ("  v:     Version and setup information") << endl;
 	*p_serial << PMS ("  d:     Stack dump for tasks") << endl;
+	*p_serial << PMS ("  P:     Profiled code region times") << endl;
+	*p_serial << PMS ("  T:     Send the RTOS trace to the PC") << endl;
+	*p_serial << PMS ("  j:     Check the jitter of delay_us()") << endl;
 	*p_serial << PMS ("  n:     Enter a number (demo)") << endl;
 	*p_serial << PMS ("  Ctl-C: Reset the AVR") << endl;
 	*p_serial << PMS ("  h:     HALP!") << endl;
@@ -268,9 +317,60 @@ void task_user::show_status (void)
 			  #else
 				<< PMS (", OCR1A: ") << OCR1A << endl << endl;
 			  #endif
+	p_serial->print_status (*p_serial);
+	*p_serial << endl;
 
 	// Have the tasks print their status; then the same for the shared data items
 	print_task_list (p_serial);
 	*p_serial << endl;
 	print_all_shares (p_serial);
 }
+
+
+//-------------------------------------------------------------------------------------
+/** This method measures the latency and jitter of @c delay_us(). Delays of several
+ *  lengths, from ones short enough to be done by watching the clock to ones which 
+ *  sleep through several RTOS ticks, are each done @c DELAY_TRIALS times. The time 
+ *  each one really took is found with @c now_us(), and the least, greatest and 
+ *  average amounts by which it ran over are printed. A delay should never end early;
+ *  if one does, an error is printed too. Other tasks run during the longer delays, so
+ *  the results show the delays as the car's tasks would see them.
+ */
+
+void task_user::check_delay_us (void)
+{
+	static const uint16_t lengths[] = {20, 80, 300, 900, 1500, 4000};
+
+	for (uint8_t which = 0; which < sizeof (lengths) / sizeof (lengths[0]); which++)
+	{
+		uint32_t least = 0xFFFFFFFF;        // Overruns in microseconds
+		uint32_t most = 0;
+		uint32_t total = 0;
+		bool early = false;                 // True if any delay ended early
+
+		for (uint8_t trial = 0; trial < DELAY_TRIALS; trial++)
+		{
+			uint64_t begun = now_us ();
+			delay_us (lengths[which]);
+			int32_t overrun = (int32_t)(now_us () - begun - lengths[which]);
+
+			if (overrun < 0)
+			{
+				early = true;
+				overrun = 0;
+			}
+			least = ((uint32_t)overrun < least) ? (uint32_t)overrun : least;
+			most = ((uint32_t)overrun > most) ? (uint32_t)overrun : most;
+			total += overrun;
+		}
+
+		*p_serial << PMS ("delay_us (") << lengths[which] << PMS ("): late by ") 
+				  << least << PMS (" to ") << most << PMS (" us, average ") 
+				  << total / DELAY_TRIALS;
+		if (early)
+		{
+			*p_serial << PMS (", ERROR: ended early");
+		}
+		*p_serial << endl;
+	}
+}
@@ -5,6 +5,10 @@
  *  Revisions:
  *    @li 11-29-2018 KM header for user control task created.
  *    @li 12-9-2018 KM last planned edit.
+ *    @li 10-17-2026 KM sleeps until a key is pressed or text is queued for printing.
+ *    @li 10-17-2026 KM includes the profiler header.
+ *    @li 10-17-2026 KM includes the RTOS trace header.
+ *    @li 10-17-2026 KM added a check of delay_us() timing for the 'j' command.
  *
  *  License:
  *	This code is based on Prof. JR Ridgely's FreeRTOS CPP example code. The FreeRTOS
@@ -34,10 +38,14 @@
 
 #include "rs232int.h"                       // ME405/507 library for serial comm.
 #include "time_stamp.h"                     // Class to implement a microsecond timer
+#include "profiler.h"                       // Times regions of code, if TASK_PROFILE
+#include "trace.h"                          // Records an RTOS trace, if TASK_TRACE
+#include "delay_us.h"                       // Delays a task by some microseconds
 #include "taskbase.h"                       // Header for ME405/507 base task class
 #include "taskqueue.h"                      // Header of wrapper for FreeRTOS queues
 #include "textqueue.h"                      // Header for a "<<" queue class
 #include "taskshare.h"                      // Header for thread-safe shared data
+#include "seqshare.h"                       // Shared data with sequence counters
 
 #include "shares.h"                         // Global ('extern') queue declarations
 
@@ -45,6 +53,12 @@
 /// This macro defines a string that identifies the name and version of this program. 
 #define PROGRAM_VERSION		PMS ("ME507 Term Project Steering V0.01")
 
+/** @brief The longest time in milliseconds the user interface task sleeps.
+ *  @details The task is woken when a character arrives at the serial port or text is
+ *  put into the print queue, so this timeout is only a backstop.
+ */
+#define USER_IDLE_TIMEOUT_MS 100
+
 
 //-------------------------------------------------------------------------------------
 
@@ -68,6 +82,9 @@ protected:
 	// This method displays information about the status of the system
 	void show_status (void);
 
+	// This method measures how late delay_us() delays of several lengths end
+	void check_delay_us (void);
+
 public:
 	// This constructor creates a user interface task object
 	task_user (const char*, unsigned portBASE_TYPE, size_t, emstream*);
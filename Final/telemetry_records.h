@@ -0,0 +1,64 @@
+//**************************************************************************************
+/** @file telemetry_records.h
+ *    This file describes the binary records which the telemetry task sends to the PC.
+ *    It is included both by the AVR program and by the decoder which runs on the PC,
+ *    host/telem_decode.cpp, so it must only use standard fixed-size types. 
+ *
+ *  Revisions:
+ *    @li 10-17-2026 KM file created for the binary telemetry link.
+ *
+ *  License:
+ *	This code is based on Prof. JR Ridgely's FreeRTOS CPP example code. The FreeRTOS
+ *	framework is used, but the tasks are a product of our 507 group. Since the original
+ *	code used the LGPL, our code will also use the LGPL.
+ *		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * 		IMPLIED 	WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * 		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * 		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ * 		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * 		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * 		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * 		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * 		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _TELEMETRY_RECORDS_H_
+#define _TELEMETRY_RECORDS_H_
+
+#include <stdint.h>                         // Standard size integer types
+
+
+/// Record type code for a drive record, sent every telemetry period.
+const uint8_t TELEM_DRIVE = 1;
+
+/// Record type code for a system record, sent once every TELEM_SYSTEM_EVERY periods.
+const uint8_t TELEM_SYSTEM = 2;
+
+
+/** @brief A snapshot of the car's drive command, state, and ultrasonic reading.
+ *  @details The fields are little-endian with no padding on both the AVR and the PC.
+ */
+struct telem_drive_record
+{
+	uint32_t time_us;                       ///< Time taken, microseconds since reset
+	int8_t motor_vel;                       ///< Commanded motor velocity, -100 to 100
+	int8_t servo_pos;                       ///< Commanded servo angle, -90 to 90 deg.
+	uint32_t cmd_age_us;                    ///< Age of the drive command, microseconds
+	uint16_t pulse_width;                   ///< Ultrasonic receiver 1 pulse width
+	uint8_t drive_state;                    ///< Drive state requested by the user
+} __attribute__ ((packed));
+
+
+/** @brief Numbers which show how well the program as a whole is running.
+ */
+struct telem_system_record
+{
+	uint32_t time_us;                       ///< Time taken, microseconds since reset
+	uint16_t heap_free;                     ///< Bytes of heap memory not yet used
+	uint16_t frames_sent;                   ///< Telemetry frames sent since reset
+	uint16_t deadline_misses;               ///< Telemetry periods which ran late
+} __attribute__ ((packed));
+
+#endif // _TELEMETRY_RECORDS_H_
@@ -120,16 +120,18 @@
 #define configENABLE_BACKWARD_COMPATIBILITY 0
 
 /** This define is set to compile some extra code that helps keep track of memory and
- *  processor usage in tasks. It does not check for state transitions in tasks. Since
- *  tracing takes up memory and processor time, it should only be used for debugging.
+ *  processor usage in tasks. It does not check for state transitions in tasks. It is
+ *  needed by @c uxTaskGetSystemState(), which @c print_task_list() uses to get each 
+ *  task's run time; it costs a few bytes per task and queue and no processor time.
  */
-#define configUSE_TRACE_FACILITY        0
+#define configUSE_TRACE_FACILITY        1
 
-/** This define causes task run times to be measured by the RTOS profiler. This is a
- *  useful debugging feature, but it takes up memory and processor time, so it should
- *  only be used when debugging the performance of a program.
+/** This define causes task run times to be measured by the RTOS profiler. The run 
+ *  time counter is made from the RTOS tick count and the hardware timer which runs
+ *  the tick interrupt, so no extra timer is needed, and reading it at each context 
+ *  switch takes only a few dozen cycles. It can therefore be left on all the time.
  */
-#define configGENERATE_RUN_TIME_STATS   0
+#define configGENERATE_RUN_TIME_STATS   1
 
 /** This define sets the maximum number of task priorities available for use. More
  *  memory is used if a higher number of priorities is set, so you should not make
@@ -168,10 +170,10 @@
 #define configUSE_IDLE_HOOK             0
 
 /** This define enables the use of vApplicationTickHook(), which runs within the
- *  RTOS tick timer interrupt. Code which does timing tasks can be put here. This
- *  functionality is seldom used.
+ *  RTOS tick timer interrupt. Code which does timing tasks can be put here. The hook
+ *  in time_stamp_now_us.cpp uses it to keep the 64-bit microsecond clock running.
  */
-#define configUSE_TICK_HOOK             0
+#define configUSE_TICK_HOOK             1
 
 /** When this define is set to 1, the RTOS tick counter will only be 16 bits in size.
  *  This makes the RTOS tick interrupt a little quicker and saves some memory, but
@@ -228,32 +230,52 @@
 #define INCLUDE_pcTaskGetTaskName                1
 #define INCLUDE_uxTaskGetStackHighWaterMark      1
 #define INCLUDE_xTaskGetIdleTaskHandle           1
+#define INCLUDE_xTaskGetSchedulerState           1
 
 
-// //-------------------------------------------------------------------------------------
-// /** @brief   Macro which is run by FreeRTOS when a task is switched in.
-//  */
-// 
-// #define traceTASK_SWITCHED_IN() task_switched_in_function ()
-// 
-// 
-// //-------------------------------------------------------------------------------------
-// /** @brief   Macro which is run by FreeRTOS when a task is switched out.
-//  */
-// 
-// #define traceTASK_SWITCHED_OUT() task_switched_out_function ()
-
 //-------------------------------------------------------------------------------------
-
-// #define configGENERATE_RUN_TIME_STATS            1
-
-//-------------------------------------------------------------------------------------
-
-// #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() ?????????
-
-//-------------------------------------------------------------------------------------
-
-// #define portGET_RUN_TIME_COUNTER_VALUE()         ?????????
+/** @brief   Macros which are run by FreeRTOS to record a trace of what it's doing.
+ *  @details If @c TASK_TRACE is defined in the Makefile, these kernel hooks write
+ *           task switches and the use of queues, semaphores and mutexes into the ring
+ *           buffer of the recorder in trace.h. Each task's number is the one FreeRTOS
+ *           gives it as it's created; each queue is given a number here as it's
+ *           created. These hooks need @c configUSE_TRACE_FACILITY to be set to 1, as 
+ *           the numbers are kept in fields which only exist then. The macros are
+ *           expanded inside the kernel, where @c pxCurrentTCB and the task and queue
+ *           structures can be seen.
+ */
+#ifdef TASK_TRACE
+	#include "trace.h"
+
+	#define traceTASK_CREATE(pxNewTCB) \
+		trace_task_created ((uint8_t)(pxNewTCB)->uxTCBNumber, (pxNewTCB)->pcTaskName)
+	#define traceTASK_SWITCHED_OUT() \
+		trace_switched_out ((uint8_t)pxCurrentTCB->uxTCBNumber)
+	#define traceTASK_SWITCHED_IN() \
+		trace_switched_in ((uint8_t)pxCurrentTCB->uxTCBNumber)
+
+	#define traceQUEUE_CREATE(pxNewQueue) \
+		(pxNewQueue)->uxQueueNumber = ++trace_queues
+	#define traceCREATE_MUTEX(pxNewQueue) \
+		(pxNewQueue)->uxQueueNumber = ++trace_queues
+
+	#define traceQUEUE_SEND(pxQueue) \
+		trace_event (TRACE_SEND, (uint8_t)(pxQueue)->uxQueueNumber)
+	#define traceQUEUE_RECEIVE(pxQueue) \
+		trace_event (TRACE_RECEIVE, (uint8_t)(pxQueue)->uxQueueNumber)
+	#define traceQUEUE_SEND_FAILED(pxQueue) \
+		trace_event (TRACE_SEND_FAILED, (uint8_t)(pxQueue)->uxQueueNumber)
+	#define traceQUEUE_RECEIVE_FAILED(pxQueue) \
+		trace_event (TRACE_RECEIVE_FAILED, (uint8_t)(pxQueue)->uxQueueNumber)
+	#define traceBLOCKING_ON_QUEUE_SEND(pxQueue) \
+		trace_event (TRACE_BLOCK_SEND, (uint8_t)(pxQueue)->uxQueueNumber)
+	#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) \
+		trace_event (TRACE_BLOCK_RECEIVE, (uint8_t)(pxQueue)->uxQueueNumber)
+	#define traceQUEUE_SEND_FROM_ISR(pxQueue) \
+		trace_event (TRACE_SEND_ISR, (uint8_t)(pxQueue)->uxQueueNumber)
+	#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue) \
+		trace_event (TRACE_RECEIVE_ISR, (uint8_t)(pxQueue)->uxQueueNumber)
+#endif
 
 //-------------------------------------------------------------------------------------
 /** This macro sets up the timer/counter to measure the run time of tasks. However, if
@@ -265,11 +287,15 @@
 //-------------------------------------------------------------------------------------
 /** This macro returns the current real time measured by the RTOS timer, truncated to
 *  fit in a 32 bit integer so that FreeRTOS's run-time statistics measurement code
-*  can make use of the time measurement. 
+*  can make use of the time measurement. The function is in time_stamp_run_time.cpp.
 */
 #define portGET_RUN_TIME_COUNTER_VALUE()  func_get_run_time_counter ()
 
-// Here's the header for the function which returns the run-time counter value
+// Here's the header for the function which returns the run-time counter value. It's
+// called from the kernel's C code, so it must have C linkage
+#ifdef __cplusplus
+extern "C"
+#endif
 uint32_t func_get_run_time_counter (void);
 
 
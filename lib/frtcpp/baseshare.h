@@ -11,6 +11,8 @@
  *
  *  Revised:
  *    \li 10-18-2014 JRR Created file
+ *    \li 10-17-2026 AG  Moved the version number type for shares here
+ *    \li 10-17-2026 AG  Added a compiler barrier for shares without critical sections
  *
  *  License:
  *		This file is copyright 2014 by JR Ridgely and released under the Lesser GNU 
@@ -36,6 +38,19 @@
 #include "emstream.h"                       // Header for base serial device class
 
 
+/** This type holds the version number of the data in a share. It's one byte so that
+ *  it can be read and incremented without a critical section. 
+ */
+typedef uint8_t share_version_t;
+
+/** This macro keeps the compiler from moving reads and writes of memory from one side
+ *  of it to the other. It generates no code. Shares which don't use critical sections
+ *  need it so that, for example, an index or counter is changed only after the data 
+ *  it refers to has been completely written.
+ */
+#define SHARE_BARRIER()   asm volatile ("" ::: "memory")
+
+
 //-------------------------------------------------------------------------------------
 /** @brief   Base class for classes that share data in a thread-safe manner between 
  *           tasks.
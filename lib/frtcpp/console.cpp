@@ -0,0 +1,217 @@
+//*************************************************************************************
+/** \file console.cpp
+ *    This file contains classes which let several tasks print to one serial device
+ *    without their text getting mixed together. Each task prints into its own small
+ *    line buffer, and whole lines are sent to the device while a mutex is held.
+ *
+ *  Revised:
+ *    \li 10-17-2026 AG  Original file
+ *    \li 10-17-2026 AG  Droppable lines are also dropped when the device is full
+ *
+ *  License:
+ *		This file is copyright 2026 by agent (AG) and released under the Lesser GNU
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * 		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * 		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * 		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ * 		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * 		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * 		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * 		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * 		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+#include "console.h"                        // Header for this file
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Constructor for a console shared by several tasks.
+ *  @details This constructor saves a pointer to the serial device and creates the
+ *           mutex which is held while each block of text is being sent.
+ *  @param   p_dev A pointer to the serial device to which text is sent
+ *  @param   a_drop_wait The number of RTOS ticks for which a droppable line waits
+ *                       for a busy console before it's thrown away (default 0)
+ */
+
+shared_console::shared_console (emstream* p_dev, TickType_t a_drop_wait)
+	: emstream ()
+{
+	p_device = p_dev;
+	drop_wait = a_drop_wait;
+	lines_sent = 0;
+	lines_delayed = 0;
+	lines_dropped = 0;
+
+	mutex = xSemaphoreCreateMutex ();
+	if (mutex == NULL)
+	{
+		DBG (p_device, PMS ("ERROR creating console mutex") << endl);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Send a block of text to the device, keeping it together.
+ *  @details This method takes the console's mutex, writes the block to the device,
+ *           and gives the mutex back. If another task is using the console, the
+ *           block is counted as delayed and this task waits; a block which isn't
+ *           droppable waits as long as it takes, while a droppable one waits only
+ *           @c drop_wait ticks and is then thrown away and counted. A droppable
+ *           block is also thrown away and counted if the device hasn't room for all
+ *           of it, since writing it would make this task wait for the device while
+ *           holding the mutex, keeping other tasks off the console. Before the
+ *           scheduler starts there are no other tasks, so the block is just sent.
+ *  @param   p_data Pointer to the characters to be written
+ *  @param   count The number of characters to write
+ *  @param   droppable True if the block may be thrown away when the console is busy
+ *  @return  True if the block was sent, false if it was dropped
+ */
+
+bool shared_console::write_line (const char* p_data, uint16_t count, bool droppable)
+{
+	if (xTaskGetSchedulerState () != taskSCHEDULER_RUNNING)
+	{
+		p_device->write (p_data, count);
+		lines_sent++;
+		return (true);
+	}
+
+	// Try to get the console without waiting; if it's busy, wait if allowed to
+	if (xSemaphoreTake (mutex, 0) != pdTRUE)
+	{
+		if (xSemaphoreTake (mutex, droppable ? drop_wait : portMAX_DELAY) != pdTRUE)
+		{
+			portENTER_CRITICAL ();
+			lines_dropped++;
+			portEXIT_CRITICAL ();
+			return (false);
+		}
+		lines_delayed++;
+	}
+
+	// A droppable block mustn't wait for room in the device, as the mutex is held
+	if (droppable && p_device->tx_room () < count)
+	{
+		xSemaphoreGive (mutex);
+		portENTER_CRITICAL ();
+		lines_dropped++;
+		portEXIT_CRITICAL ();
+		return (false);
+	}
+
+	// The counts are only changed here while the mutex is held
+	p_device->write (p_data, count);
+	lines_sent++;
+	xSemaphoreGive (mutex);
+
+	return (true);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Print the console's counts, then the status of its device.
+ *  @details This method shows how many lines have been sent, how many had to wait
+ *           for another task's line to be sent, and how many were dropped; then it
+ *           asks the device to print its own status.
+ *  @param   ser_dev A reference to the serial device on which to print the status
+ */
+
+void shared_console::print_status (emstream& ser_dev)
+{
+	ser_dev << PMS ("Console: ") << lines_sent << PMS (" lines, ")
+			<< lines_delayed << PMS (" delayed, ") << lines_dropped
+			<< PMS (" dropped") << endl;
+	p_device->print_status (ser_dev);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Constructor for one task's line buffer on a shared console.
+ *  @details This constructor allocates the buffer in which a line is collected.
+ *  @param   p_con A pointer to the console to which lines are sent
+ *  @param   a_size The number of characters the line buffer can hold
+ *  @param   is_droppable True if this task's lines may be thrown away when the
+ *                        console is busy (default @c false)
+ */
+
+console_line::console_line (shared_console* p_con, uint8_t a_size,
+							bool is_droppable)
+	: emstream ()
+{
+	p_console = p_con;
+	size = a_size;
+	count = 0;
+	droppable = is_droppable;
+
+	p_buffer = new char[a_size];
+	if (p_buffer == NULL)
+	{
+		size = 0;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Put one character into the line.
+ *  @details This method just calls @c write() to put a block which is one character
+ *           long into the line.
+ *  @param   a_char The character to be put into the line
+ */
+
+void console_line::putchar (char a_char)
+{
+	write (&a_char, 1);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Put a block of characters into the line.
+ *  @details This method copies characters into the line buffer. When a @c '\\n' is
+ *           copied, which ends a line, or when the buffer fills up, the buffer is
+ *           sent to the console as one block and emptied. If the buffer couldn't be
+ *           allocated, the characters are sent straight to the console.
+ *  @param   p_data Pointer to the characters to be written
+ *  @param   n_chars The number of characters to write
+ *  @return  The number of characters which were written
+ */
+
+uint16_t console_line::write (const char* p_data, uint16_t n_chars)
+{
+	if (size == 0)
+	{
+		p_console->write_line (p_data, n_chars, droppable);
+		return (n_chars);
+	}
+
+	for (uint16_t left = n_chars; left > 0; left--)
+	{
+		char ch = *p_data++;
+
+		p_buffer[count++] = ch;
+		if (ch == '\n' || count >= size)
+		{
+			transmit_now ();
+		}
+	}
+	return (n_chars);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Send whatever is in the line buffer to the console at once.
+ *  @details This method is called when a line ends or the buffer is full, and it can
+ *           be called with the @c send_now manipulator to send part of a line, such
+ *           as a prompt, which isn't followed by a newline.
+ */
+
+void console_line::transmit_now (void)
+{
+	if (count != 0)
+	{
+		p_console->write_line (p_buffer, count, droppable);
+		count = 0;
+	}
+}
@@ -0,0 +1,218 @@
+//*************************************************************************************
+/** \file console.h
+ *    This file contains classes which let several tasks print to one serial device
+ *    without their text getting mixed together. Each task prints into its own small
+ *    line buffer, and whole lines are sent to the device while a mutex is held, so a
+ *    line from one task never shows up in the middle of a line from another.
+ *
+ *  Revised:
+ *    \li 10-17-2026 AG  Original file
+ *    \li 10-17-2026 AG  Droppable lines are also dropped when the device is full
+ *
+ *  License:
+ *		This file is copyright 2026 by agent (AG) and released under the Lesser GNU
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * 		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * 		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * 		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ * 		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * 		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * 		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * 		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * 		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _CONSOLE_H_
+#define _CONSOLE_H_
+
+#include "FreeRTOS.h"                       // Main header for FreeRTOS
+#include "task.h"                           // Header for FreeRTOS task functions
+#include "semphr.h"                         // Header for FreeRTOS semaphores
+#include "emstream.h"                       // Pull in the base class header file
+
+
+/** This is the default number of characters in each task's console line buffer. A
+ *  line longer than this is sent in pieces, each of which is kept together.
+ */
+const uint8_t CONSOLE_LINE_SIZE = 48;
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Sends blocks of text from several tasks to one serial device, keeping
+ *           each block together.
+ *  @details A shared console owns a serial device, such as an @c rs232 port, and a
+ *           FreeRTOS mutex. Each block of text given to @c write() or
+ *           @c write_line() is sent to the device while the mutex is held, so blocks
+ *           from different tasks don't get mixed up. Because a FreeRTOS mutex uses
+ *           priority inheritance, a low priority task which holds the console while
+ *           its line goes out is raised to the priority of any task waiting for it.
+ *
+ *           Tasks usually don't write to the console directly; each is given a
+ *           @c console_line which collects a line of text and sends it here when the
+ *           line ends. A line may be marked as droppable. If the console is busy,
+ *           which happens when the serial line can't keep up with the text being
+ *           printed, a droppable line waits only @c drop_wait ticks for the console
+ *           and is thrown away if it doesn't get it. A droppable line is also thrown
+ *           away if the device hasn't room for all of it, as found by the device's
+ *           @c tx_room(), so that it never waits for the device while holding the
+ *           console. This keeps chatty debugging prints in high priority tasks from
+ *           holding those tasks or the console up. The console
+ *           counts the lines sent, the lines which had to wait for another task's
+ *           line, and the lines dropped.
+ *
+ *           Before the scheduler starts, text is sent straight to the device.
+ *
+ *  \section Usage
+ *  @code
+ *  shared_console* p_console = new shared_console (p_ser_port);
+ *  ...
+ *  new task_motor ("Motor", task_priority (8), 200,
+ *                  new console_line (p_console, CONSOLE_LINE_SIZE, true));
+ *  @endcode
+ */
+
+class shared_console : public emstream
+{
+	// This protected data can only be accessed from this class or its descendents
+	protected:
+		emstream* p_device;                 ///< The device to which text is sent
+		SemaphoreHandle_t mutex;            ///< Held while a block is being sent
+		TickType_t drop_wait;               ///< Ticks a droppable line may wait
+		uint16_t lines_sent;                ///< Number of blocks sent
+		uint16_t lines_delayed;             ///< Blocks which waited for the mutex
+		uint16_t lines_dropped;             ///< Droppable blocks thrown away
+
+	// Public methods can be called from anywhere in the program where there is a
+	// pointer or reference to an object of this class
+	public:
+		// The constructor saves the device and creates the mutex
+		shared_console (emstream* p_dev, TickType_t a_drop_wait = 0);
+
+		// Send a block of text to the device while holding the mutex
+		bool write_line (const char* p_data, uint16_t count, bool droppable);
+
+		/** This method sends a block of text to the device, keeping it together. It
+		 *  waits as long as it takes for the console to be free.
+		 *  @param p_data Pointer to the characters to be written
+		 *  @param count The number of characters to write
+		 *  @return The number of characters which were written
+		 */
+		uint16_t write (const char* p_data, uint16_t count)
+		{
+			write_line (p_data, count, false);
+			return (count);
+		}
+
+		/** This method sends one character to the device as a block of its own.
+		 *  @param a_char The character to be sent
+		 */
+		void putchar (char a_char)
+		{
+			write_line (&a_char, 1, false);
+		}
+
+		/** This method checks if a character has been received by the device.
+		 *  @return True if a character is waiting, false if not
+		 */
+		bool check_for_char (void)
+		{
+			return (p_device->check_for_char ());
+		}
+
+		/** This method gets a character from the device, waiting if there isn't one.
+		 *  @return The character which was received
+		 */
+		char getchar (void)
+		{
+			return (p_device->getchar ());
+		}
+
+		/** This method returns the number of lines thrown away because the console
+		 *  was busy.
+		 *  @return The number of lines dropped since the console was created
+		 */
+		uint16_t get_lines_dropped (void)
+		{
+			return (lines_dropped);
+		}
+
+		/** This method returns the number of lines which had to wait while another
+		 *  task's line was sent.
+		 *  @return The number of lines delayed since the console was created
+		 */
+		uint16_t get_lines_delayed (void)
+		{
+			return (lines_delayed);
+		}
+
+		// Show the console's counts, then the device's status
+		void print_status (emstream&);
+};
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Collects one task's text into lines which are sent to a shared console.
+ *  @details Each task which prints to a shared console has its own @c console_line,
+ *           used just as a serial port would be. Characters are kept in a small
+ *           buffer until the end of a line, marked by @c '\\n', or until the buffer
+ *           fills; then they're sent to the console in one block. A partly written
+ *           line can be sent at once with the @c send_now manipulator. Because the
+ *           buffer belongs to one task, a @c console_line must never be shared by
+ *           two tasks. Reading characters and printing status are passed through to
+ *           the console.
+ */
+
+class console_line : public emstream
+{
+	// This protected data can only be accessed from this class or its descendents
+	protected:
+		shared_console* p_console;          ///< The console to which lines are sent
+		char* p_buffer;                     ///< Memory which holds part of a line
+		uint8_t size;                       ///< Size of the buffer in characters
+		uint8_t count;                      ///< Number of characters in the buffer
+		bool droppable;                     ///< True if a busy console drops lines
+
+	// Public methods can be called from anywhere in the program where there is a
+	// pointer or reference to an object of this class
+	public:
+		// The constructor allocates the line buffer
+		console_line (shared_console* p_con, uint8_t a_size = CONSOLE_LINE_SIZE,
+					  bool is_droppable = false);
+
+		void putchar (char);                // Put one character in the line
+
+		// Put a block of characters in the line, sending each line as it's finished
+		uint16_t write (const char* p_data, uint16_t n_chars);
+
+		void transmit_now (void);           // Send a partly written line at once
+
+		/** This method checks if a character has been received by the console.
+		 *  @return True if a character is waiting, false if not
+		 */
+		bool check_for_char (void)
+		{
+			return (p_console->check_for_char ());
+		}
+
+		/** This method gets a character from the console, waiting if there isn't one.
+		 *  @return The character which was received
+		 */
+		char getchar (void)
+		{
+			return (p_console->getchar ());
+		}
+
+		/** This method prints the status of the console and its device.
+		 *  @param ser_dev The serial device on which to print the status
+		 */
+		void print_status (emstream& ser_dev)
+		{
+			p_console->print_status (ser_dev);
+		}
+};
+
+#endif  // _CONSOLE_H_
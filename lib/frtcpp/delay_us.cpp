@@ -0,0 +1,223 @@
+//*************************************************************************************
+/** \file delay_us.cpp
+ *    This file contains a function which delays a task for a given number of 
+ *    microseconds, using compare channel B of the RTOS tick timer to wake the task at
+ *    the end of the delay.
+ *
+ *  Revised:
+ *    \li 10-17-2026 AG  Original file
+ *
+ *  License:
+ *		This file is copyright 2026 by agent (AG) and released under the Lesser GNU
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * 		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * 		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * 		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ * 		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * 		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * 		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * 		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * 		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+#include <avr/io.h>                         // For the hardware timer registers
+#include <avr/interrupt.h>                  // For the compare match ISR
+
+#include "FreeRTOS.h"                       // Main header for FreeRTOS
+#include "task.h"                           // Header for FreeRTOS task functions
+#include "semphr.h"                         // Header for FreeRTOS semaphores
+#include "time_stamp.h"                     // The microsecond clock
+#include "delay_us.h"                       // Header for this file
+
+
+// These defines pick out the registers for compare channel B of whichever timer runs
+// the RTOS tick. Channel A resets the timer at each tick; channel B is otherwise free
+#if (defined TIMER5_COMPA_vect)
+	#define DLY_TCNT        TCNT5
+	#define DLY_OCR         OCR5B
+	#define DLY_TIFR        TIFR5
+	#define DLY_TIMSK       TIMSK5
+	#define DLY_TICK_FLAG   OCF5A
+	#define DLY_FLAG        OCF5B
+	#define DLY_ENABLE      OCIE5B
+	#define DLY_VECT        TIMER5_COMPB_vect
+#elif (defined TIMER3_COMPA_vect)
+	#define DLY_TCNT        TCNT3
+	#define DLY_OCR         OCR3B
+	#define DLY_TIFR        TIFR3
+	#define DLY_TIMSK       TIMSK3
+	#define DLY_TICK_FLAG   OCF3A
+	#define DLY_FLAG        OCF3B
+	#define DLY_ENABLE      OCIE3B
+	#define DLY_VECT        TIMER3_COMPB_vect
+#else
+	#define DLY_TCNT        TCNT1
+	#define DLY_OCR         OCR1B
+	#define DLY_TIFR        TIFR1
+	#define DLY_TIMSK       TIMSK1
+	#define DLY_TICK_FLAG   OCF1A
+	#define DLY_FLAG        OCF1B
+	#define DLY_ENABLE      OCIE1B
+	#define DLY_VECT        TIMER1_COMPB_vect
+#endif
+
+
+/// This mutex is held by the task whose delay is using the compare channel.
+static SemaphoreHandle_t delay_mutex = NULL;
+
+/// This semaphore is given by the compare ISR when the delay has ended.
+static SemaphoreHandle_t delay_done = NULL;
+
+/// This is the time, from @c now_us(), at which the current delay ends.
+static volatile uint64_t delay_deadline = 0;
+
+
+//-------------------------------------------------------------------------------------
+/** This function waits for the clock to reach the deadline, using the processor the
+ *  whole time. It's used for very short delays and for the last few microseconds of
+ *  longer ones.
+ *  @param deadline The time, from @c now_us(), at which to stop waiting
+ */
+
+static void spin_until (uint64_t deadline)
+{
+	while (now_us () < deadline)
+	{
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function creates the mutex and semaphore used by @c delay_us() the first 
+ *  time they're needed. The scheduler is suspended meanwhile so that two tasks can't
+ *  both create them. 
+ *  @return True if both exist, false if there wasn't enough memory for them
+ */
+
+static bool delay_setup (void)
+{
+	if (delay_done == NULL)
+	{
+		vTaskSuspendAll ();
+		if (delay_mutex == NULL)
+		{
+			delay_mutex = xSemaphoreCreateMutex ();
+		}
+		if (delay_done == NULL)
+		{
+			delay_done = xSemaphoreCreateBinary ();
+		}
+		xTaskResumeAll ();
+	}
+	return (delay_mutex != NULL && delay_done != NULL);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function delays the calling task for the given number of microseconds. The 
+ *  delay is never shorter than asked for; it's usually longer by only the few
+ *  microseconds needed to switch tasks. 
+ * 
+ *  Delays of up to @c DELAY_US_SPIN microseconds are done by watching the clock. For
+ *  longer ones, the task first sleeps through all but one or two of the whole RTOS 
+ *  ticks in the delay. Then compare channel B of the tick timer is set to match at 
+ *  the hardware count at which the delay ends, and the task waits for the compare 
+ *  ISR to wake it. The channel matches once per tick, so if the deadline is more 
+ *  than a tick away, the ISR sees that it's too early and lets the timer go around 
+ *  again. There's only one compare channel, so if two tasks need it at once, the 
+ *  second waits for the first, which holds it for less than two ticks.
+ * 
+ *  If the interrupt doesn't come when it should, or the mutex and semaphore can't be
+ *  created, the task watches the clock instead, so the delay still ends on time.
+ *  This function must not be called from an ISR or before the scheduler starts.
+ *  @param duration_us The number of microseconds for which to delay
+ */
+
+void delay_us (uint32_t duration_us)
+{
+	uint64_t deadline = now_us () + duration_us;
+	uint64_t now;                           // The time when the channel is set up
+	uint32_t left;                          // Microseconds left until the deadline
+	HW_CTR_TYPE hw_count;                   // Count in the hardware timer
+	uint32_t match;                         // Hardware count at which delay ends
+
+	if (duration_us <= DELAY_US_SPIN || !delay_setup ())
+	{
+		spin_until (deadline);
+		return;
+	}
+
+	// Sleep through whole ticks; waking will be one to two ticks before the deadline
+	if (duration_us >= 2 * US_PER_TICK)
+	{
+		vTaskDelay (us_to_ticks (duration_us) - 1);
+	}
+
+	xSemaphoreTake (delay_mutex, portMAX_DELAY);
+
+	// Find the hardware count at which the delay ends. Interrupts are off so that the
+	// hardware count is read in the same tick as the clock
+	portENTER_CRITICAL ();
+	now = now_us ();
+	hw_count = DLY_TCNT;
+	if ((DLY_TIFR & (1 << DLY_TICK_FLAG)) && hw_count < (TMR_MAX_CT / 2))
+	{
+		hw_count += TMR_MAX_CT;
+	}
+
+	// If the task was held up and there isn't much time left, just watch the clock
+	if (deadline > now + DELAY_US_SPIN)
+	{
+		left = (uint32_t)(deadline - now);
+		match = (hw_count + us_to_hw_count (left)) % TMR_MAX_CT;
+		delay_deadline = deadline;
+		DLY_OCR = (HW_CTR_TYPE)match;
+		DLY_TIFR = (1 << DLY_FLAG);         // Writing a one clears an old match
+		DLY_TIMSK |= (1 << DLY_ENABLE);
+		portEXIT_CRITICAL ();
+
+		// Wait for the ISR; if it hasn't come a couple of ticks after it should 
+		// have, something's wrong, so turn the interrupt off and clear any late give
+		if (xSemaphoreTake (delay_done, us_to_ticks (left) + 2) != pdTRUE)
+		{
+			portENTER_CRITICAL ();
+			DLY_TIMSK &= ~(1 << DLY_ENABLE);
+			portEXIT_CRITICAL ();
+			xSemaphoreTake (delay_done, 0);
+		}
+	}
+	else
+	{
+		portEXIT_CRITICAL ();
+	}
+
+	xSemaphoreGive (delay_mutex);
+	spin_until (deadline);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This is the compare match ISR for channel B of the tick timer. If the deadline of
+ *  the current delay is near, it turns itself off and wakes the delayed task. Like 
+ *  the serial port ISRs in the FreeRTOS AVR demos, it calls @c taskYIELD() when the
+ *  woken task has a higher priority than the one which was interrupted, so the 
+ *  delayed task runs right away rather than at the next tick. 
+ */
+
+ISR (DLY_VECT)
+{
+	signed portBASE_TYPE woken = pdFALSE;
+
+	if (now_us () + DELAY_US_SLACK >= delay_deadline)
+	{
+		DLY_TIMSK &= ~(1 << DLY_ENABLE);
+		xSemaphoreGiveFromISR (delay_done, &woken);
+		if (woken != pdFALSE)
+		{
+			taskYIELD ();
+		}
+	}
+}
@@ -0,0 +1,52 @@
+//*************************************************************************************
+/** \file delay_us.h
+ *    This file contains a function which delays a task for a given number of 
+ *    microseconds. Very short delays are done by watching the microsecond clock; 
+ *    longer ones sleep through whole RTOS ticks and then have a spare compare channel
+ *    of the RTOS tick timer wake the task at the exact microsecond, so other tasks 
+ *    can use the processor while this one waits.
+ *
+ *  Revised:
+ *    \li 10-17-2026 AG  Original file
+ *
+ *  License:
+ *		This file is copyright 2026 by agent (AG) and released under the Lesser GNU
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * 		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * 		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * 		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ * 		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * 		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * 		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * 		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * 		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _DELAY_US_H_
+#define _DELAY_US_H_
+
+#include "FreeRTOS.h"                       // Main header for FreeRTOS
+
+
+/** Delays of this many microseconds or less are done by watching the clock rather 
+ *  than by letting the task sleep. Putting a task to sleep and waking it takes two
+ *  context switches and an interrupt, which together take tens of microseconds, so
+ *  sleeping through a shorter wait doesn't save anything.
+ */
+const uint16_t DELAY_US_SPIN = 50;
+
+/** The compare interrupt wakes the waiting task once the deadline is this many 
+ *  microseconds away or less; the task then watches the clock for the last few 
+ *  microseconds, so that the delay never ends early.
+ */
+const uint8_t DELAY_US_SLACK = 10;
+
+
+// Delay the calling task for the given number of microseconds
+void delay_us (uint32_t duration_us);
+
+#endif  // _DELAY_US_H_
@@ -0,0 +1,137 @@
+//*************************************************************************************
+/** @file    periodictask.cpp
+ *  @brief   Source code for a task class which runs its code at a fixed period and 
+ *           keeps track of how well it meets that period.
+ *  @details This file contains the task loop for periodic tasks and the code which
+ *           prints their timing measurements. 
+ *
+ *  Revised:
+ *    \li 10-17-2026 AG  Original file
+ *
+ *  License:
+ *		This file is copyright 2026 by agent (AG) and released under the Lesser GNU 
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+#include "periodictask.h"                   // Pull in the header for this class
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Constructor which creates and initializes a periodic task object.
+ *  @details This constructor calls the @c TaskBase constructor to create the RTOS
+ *           task, then saves the period and clears the timing measurements.
+ *  @param   a_name A character string which will be the name of this task
+ *  @param   a_priority The priority at which this task will initially run
+ *  @param   a_stack_size The size of this task's stack in bytes 
+ *  @param   period_ms The time between runs of @c step() in milliseconds
+ *  @param   p_ser_dev Pointer to a serial device which can be used by this task to
+ *                     communicate (default: NULL)
+ */
+
+PeriodicTask::PeriodicTask (const char* a_name, unsigned portBASE_TYPE a_priority, 
+							size_t a_stack_size, TickType_t period_ms, 
+							emstream* p_ser_dev)
+	: TaskBase (a_name, a_priority, a_stack_size, p_ser_dev)
+{
+	period = ((uint32_t)period_ms * configTICK_RATE_HZ) / 1000UL;
+	if (period == 0)
+	{
+		period = 1;
+	}
+
+	min_period_us = 0xFFFFFFFF;
+	max_period_us = 0;
+	avg_period_us_x16 = ((uint32_t)period * (1000000UL / configTICK_RATE_HZ)) << 4;
+	deadline_misses = 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Run @c step() once per period and keep track of the timing.
+ *  @details This is the task loop for periodic tasks. It measures the time since the
+ *           previous period began, runs the user's @c step() method, counts a missed
+ *           deadline if @c step() ran into the next period, and then sleeps until the
+ *           next period begins. 
+ */
+
+void PeriodicTask::run (void)
+{
+	time_stamp now;                         // The time at which a period begins
+	time_stamp interval;                    // Time between this and the last period
+	uint32_t interval_us;                   // The same interval in microseconds
+
+	previous_wake = get_tick_count ();
+
+	for (;;)
+	{
+		now.set_to_now ();
+
+		// There's no previous period to compare with the first time through
+		if (runs != 0)
+		{
+			interval = now - last_start;
+			interval_us = interval.get_seconds () * 1000000UL 
+						  + interval.get_microsec ();
+
+			if (interval_us < min_period_us)
+			{
+				min_period_us = interval_us;
+			}
+			if (interval_us > max_period_us)
+			{
+				max_period_us = interval_us;
+			}
+			avg_period_us_x16 += interval_us - (avg_period_us_x16 >> 4);
+		}
+		last_start = now;
+
+		step ();
+		runs++;
+
+		// If the next period should already have started, we've missed a deadline
+		if ((TickType_t)(get_tick_count () - previous_wake) >= period)
+		{
+			deadline_misses++;
+		}
+
+		delay_from_for (previous_wake, period);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Print the status of this task, including its timing measurements.
+ *  @details This method prints the usual task status, then the shortest, average, and
+ *           longest periods measured in microseconds and the number of missed 
+ *           deadlines. 
+ *  @param   ser_dev A reference to the serial device to which to print the status
+ */
+
+void PeriodicTask::print_status (emstream& ser_dev)
+{
+	// Call the parent task's printing function first
+	TaskBase::print_status (ser_dev);
+
+	ser_dev << PMS ("\tus: ");
+	if (min_period_us <= max_period_us)
+	{
+		ser_dev << min_period_us << '/' << (avg_period_us_x16 >> 4) << '/' 
+				<< max_period_us;
+	}
+	else
+	{
+		ser_dev << '-';
+	}
+	ser_dev << PMS (" late: ") << deadline_misses;
+}
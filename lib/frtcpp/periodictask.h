@@ -0,0 +1,134 @@
+//*************************************************************************************
+/** @file    periodictask.h
+ *  @brief   Headers for a task class which runs its code at a fixed period and keeps
+ *           track of how well it meets that period.
+ *  @details This file contains a descendent of class @c TaskBase whose task loop is
+ *           run by the parent class at a regular interval using @c vTaskDelayUntil().
+ *           The time between runs is measured with a @c time_stamp so that jitter and
+ *           missed deadlines can be seen in the task list.
+ *
+ *  Revised:
+ *    \li 10-17-2026 AG  Original file
+ *
+ *  License:
+ *		This file is copyright 2026 by agent (AG) and released under the Lesser GNU 
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _PERIODICTASK_H_
+#define _PERIODICTASK_H_
+
+#include "FreeRTOS.h"                       // Main header for FreeRTOS
+#include "task.h"                           // Header for FreeRTOS tasks
+
+#include "taskbase.h"                       // Pull in the base class header file
+#include "time_stamp.h"                     // Used to measure the period precisely
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Base class for tasks which must run their code at a regular interval.
+ *  @details This class owns the task loop. Each period it calls the user's @c step()
+ *           method, then uses @c delay_from_for() (which calls @c vTaskDelayUntil() ) 
+ *           to sleep until the beginning of the next period, so the time taken by 
+ *           @c step() doesn't make the period drift as it does when @c delay_ms() is 
+ *           called at the end of a loop. 
+ * 
+ *           At the beginning of every period the time is measured with a 
+ *           @c time_stamp, and the shortest, longest, and average actual periods are 
+ *           kept. If @c step() is still running when the next period should have 
+ *           begun, a deadline miss is counted. These figures are shown at the end of
+ *           the task's line in @c print_task_list(). 
+ * 
+ *  @section Usage
+ *  A periodic task supplies a @c step() method instead of a @c run() method. The 
+ *  @c step() method does one period's worth of work and returns; it must not contain
+ *  a loop or a delay. The variable @c state can be used in the usual way:
+ *  @code
+ *  class TaskExample : public PeriodicTask
+ *  {
+ *  public:
+ *      TaskExample (const char*, unsigned portBASE_TYPE, size_t, emstream*);
+ *      void step (void);
+ *  };
+ *  ...
+ *  TaskExample::TaskExample (const char* a_name, unsigned portBASE_TYPE a_priority,
+ *                            size_t a_stack_size, emstream* p_serial_dev)
+ *      : PeriodicTask (a_name, a_priority, a_stack_size, 5, p_serial_dev)
+ *  {
+ *  }
+ *  @endcode
+ *  The task above has its @c step() method run every 5 milliseconds.
+ */
+
+class PeriodicTask : public TaskBase
+{
+	protected:
+		/// This is the period at which @c step() is run, in RTOS ticks.
+		TickType_t period;
+
+		/// This is the RTOS tick count at which the current period began.
+		TickType_t previous_wake;
+
+		/// This is the time at which the most recent call to @c step() began.
+		time_stamp last_start;
+
+		/// This is the shortest time measured between calls to @c step(), in us.
+		uint32_t min_period_us;
+
+		/// This is the longest time measured between calls to @c step(), in us.
+		uint32_t max_period_us;
+
+		/** This is sixteen times a running average of the time between calls to 
+		 *  @c step() in microseconds. Each new measurement has a weight of 1/16, so
+		 *  the average follows roughly the last 16 periods.
+		 */
+		uint32_t avg_period_us_x16;
+
+		/** This is the number of times @c step() was still running when the next 
+		 *  period should have begun.
+		 */
+		uint32_t deadline_misses;
+
+	public:
+		// This constructor creates a task which runs step() every given milliseconds
+		PeriodicTask (const char* a_name, 
+					  unsigned portBASE_TYPE a_priority, 
+					  size_t a_stack_size,
+					  TickType_t period_ms,
+					  emstream* p_ser_dev = NULL);
+
+		/** @brief   Method which holds one period's worth of the user's task code.
+		 *  @details This method is called once per period by @c run(). It must be 
+		 *           written in each descendent class, and it must return rather than
+		 *           loop forever; the looping and timing are done by this class.
+		 */
+		virtual void step (void) = 0;
+
+		// The task loop, which calls step() once per period and keeps timing records
+		void run (void);
+
+		/** @brief   Return the number of deadlines which this task has missed.
+		 *  @return  The number of periods in which @c step() ran too long
+		 */
+		uint32_t get_deadline_misses (void)
+		{
+			return (deadline_misses);
+		}
+
+		// Print the status of this task, including the timing measurements
+		void print_status (emstream&);
+};
+
+#endif  // _PERIODICTASK_H_
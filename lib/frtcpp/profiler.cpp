@@ -0,0 +1,214 @@
+//*************************************************************************************
+/** \file profiler.cpp
+ *    This file contains a simple profiler which measures how long chosen regions of 
+ *    code take to run, keeping a count, the shortest and longest times, and a 
+ *    histogram of times for each region. 
+ *
+ *  Revised:
+ *    \li 10-17-2026 AG  Original file
+ *
+ *  License:
+ *		This file is copyright 2026 by agent (AG) and released under the Lesser GNU
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * 		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * 		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * 		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ * 		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * 		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * 		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * 		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * 		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+#include <string.h>                         // For memcpy()
+#include <avr/pgmspace.h>                   // For strlen_P(), names kept in flash
+#include "profiler.h"                       // Header for this file
+
+
+// Set the pointer to the most recently created region to initially be NULL
+profile_region* profile_region::p_newest = NULL;
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Constructor for a profiled region of code.
+ *  @details This constructor saves the region's name, clears its measurements, and
+ *           installs it in the linked list of regions. Regions are usually created
+ *           at file scope by the @c PROFILE_REGION() macro, before the scheduler 
+ *           starts.
+ *  @param   p_pgm_name The name of the region, in a string kept in program memory
+ */
+
+profile_region::profile_region (const char* p_pgm_name)
+{
+	p_name = p_pgm_name;
+	reset ();
+
+	p_next = p_newest;
+	p_newest = this;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Count one run of the region.
+ *  @details This method updates the count, the shortest and longest times, and the
+ *           histogram. The histogram bucket is the number of bits needed to hold the
+ *           time, found by shifting the time right until it's gone; this takes at 
+ *           most one step per bucket. The count of runs in a bucket stops at its
+ *           largest value rather than going back to zero. This method may be called
+ *           from within an ISR.
+ *  @param   duration The time taken by the run of the region, in microseconds
+ */
+
+void profile_region::record (uint32_t duration)
+{
+	uint8_t bucket = 0;
+
+	runs++;
+	if (duration < shortest)
+	{
+		shortest = duration;
+	}
+	if (duration > longest)
+	{
+		longest = duration;
+	}
+
+	for (uint32_t left = duration; left != 0 && bucket < (PROFILE_BUCKETS - 1); 
+		 left >>= 1)
+	{
+		bucket++;
+	}
+	if (histogram[bucket] != 0xFFFF)
+	{
+		histogram[bucket]++;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Clear the measurements of the region.
+ *  @details This method sets the count and histogram to zero. The shortest time is
+ *           set to the largest possible number so that the first run will replace it.
+ *           It's done in a critical section so that a run being recorded by a task or
+ *           an ISR can't be half cleared.
+ */
+
+void profile_region::reset (void)
+{
+	portENTER_CRITICAL ();
+	runs = 0;
+	shortest = 0xFFFFFFFF;
+	longest = 0;
+	for (uint8_t index = 0; index < PROFILE_BUCKETS; index++)
+	{
+		histogram[index] = 0;
+	}
+	portEXIT_CRITICAL ();
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Print a line showing the measurements of this region.
+ *  @details This method copies the measurements inside a critical section, so that a
+ *           run recorded by an ISR while the line is being printed can't mix old and
+ *           new numbers, then prints the region's name, number of runs, shortest and
+ *           longest times in microseconds, and the nonzero histogram buckets. Each
+ *           bucket is shown as the upper limit of its times, then the number of runs 
+ *           in it; for example, "<64:12" means 12 runs took from 32 to 63 us.
+ *  @param   p_ser_dev A pointer to the serial device on which to print the line
+ */
+
+void profile_region::print_in_list (emstream* p_ser_dev)
+{
+	uint32_t runs_now;                      // Copies of the measurements, so that
+	uint32_t shortest_now;                  // they all come from the same moment
+	uint32_t longest_now;
+	uint16_t histogram_now[PROFILE_BUCKETS];
+
+	portENTER_CRITICAL ();
+	runs_now = runs;
+	shortest_now = shortest;
+	longest_now = longest;
+	memcpy (histogram_now, histogram, sizeof (histogram));
+	portEXIT_CRITICAL ();
+
+	// Print the region's name and pad it to 16 characters
+	*p_ser_dev << _p_str << p_name;
+	for (uint8_t cols = strlen_P (p_name); cols < 16; cols++)
+	{
+		p_ser_dev->putchar (' ');
+	}
+
+	*p_ser_dev << runs_now << '\t';
+	if (runs_now == 0)
+	{
+		*p_ser_dev << PMS ("-\t-") << endl;
+		return;
+	}
+	*p_ser_dev << shortest_now << '\t' << longest_now << '\t';
+
+	for (uint8_t index = 0; index < PROFILE_BUCKETS; index++)
+	{
+		if (histogram_now[index] != 0)
+		{
+			if (index == PROFILE_BUCKETS - 1)
+			{
+				*p_ser_dev << PMS (" >=") << (uint32_t)(1UL << (index - 1));
+			}
+			else
+			{
+				*p_ser_dev << PMS (" <") << (uint32_t)(1UL << index);
+			}
+			*p_ser_dev << ':' << histogram_now[index];
+		}
+	}
+	*p_ser_dev << endl;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Print a table of the measurements of all the profiled regions.
+ *  @details This function prints a heading, then one line for each region, newest
+ *           first. If no regions exist, which is the case when the program wasn't 
+ *           compiled with @c TASK_PROFILE defined, a note is printed instead.
+ *  @param   p_ser_dev A pointer to the serial device on which to print the table
+ */
+
+void print_all_profiles (emstream* p_ser_dev)
+{
+	if (profile_region::p_newest == NULL)
+	{
+		*p_ser_dev << PMS ("No profiled regions; compile with -DTASK_PROFILE") 
+				   << endl;
+		return;
+	}
+
+	*p_ser_dev << PMS ("Region          Runs\tMin us\tMax us\tHistogram (us:runs)") 
+			   << endl;
+	*p_ser_dev << PMS ("------          ----\t------\t------\t-------------------") 
+			   << endl;
+	for (profile_region* p_region = profile_region::p_newest; p_region != NULL;
+		 p_region = p_region->p_next)
+	{
+		p_region->print_in_list (p_ser_dev);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Clear the measurements of all the profiled regions.
+ *  @details This function lets a new set of measurements be started, for example 
+ *           after the program has finished setting itself up.
+ */
+
+void reset_all_profiles (void)
+{
+	for (profile_region* p_region = profile_region::p_newest; p_region != NULL;
+		 p_region = p_region->p_next)
+	{
+		p_region->reset ();
+	}
+}
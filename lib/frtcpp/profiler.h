@@ -0,0 +1,198 @@
+//*************************************************************************************
+/** \file profiler.h
+ *    This file contains a simple profiler which measures how long chosen regions of 
+ *    code take to run. Each region keeps a count of its runs, the shortest and longest
+ *    run, and a histogram of run times in buckets which double in width. Times are
+ *    read from the microsecond clock behind class @c time_stamp, which may be read in
+ *    interrupt service routines, so ISR bodies can be measured too. Unless 
+ *    @c TASK_PROFILE is defined in the Makefile, the macros which declare and measure
+ *    regions produce no code at all.
+ *
+ *  Revised:
+ *    \li 10-17-2026 AG  Original file
+ *
+ *  License:
+ *		This file is copyright 2026 by agent (AG) and released under the Lesser GNU
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * 		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * 		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * 		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ * 		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * 		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * 		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * 		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * 		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include "FreeRTOS.h"                       // Main header for FreeRTOS
+#include "emstream.h"                       // Header for base serial device class
+#include "time_stamp.h"                     // The microsecond clock used for timing
+
+
+/** This is the number of buckets in each region's histogram. Bucket 0 counts runs 
+ *  which took less than a microsecond; bucket @a n counts those which took from 
+ *  2<sup>@a n-1</sup> up to 2<sup>@a n</sup> microseconds. The last bucket also counts
+ *  everything longer, which with 16 buckets is 16 ms or more.
+ */
+const uint8_t PROFILE_BUCKETS = 16;
+
+
+//-------------------------------------------------------------------------------------
+/** This function reads the clock used to time profiled regions. It's the low 32 bits
+ *  of @c now_us(), so it may be read in an ISR; differences between two readings are
+ *  correct for times up to about 71 minutes.
+ *  @return The time in microseconds, modulo 2<sup>32</sup>
+ */
+
+inline uint32_t profile_now (void)
+{
+	return ((uint32_t)now_us ());
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Holds the measurements of the run times of one region of code.
+ *  @details A profiled region is usually declared at file scope with the 
+ *           @c PROFILE_REGION() macro, which keeps its name in program memory. Each 
+ *           time the region runs, its time is given to @c record() by a 
+ *           @c profile_probe or by the @c PROFILE_BEGIN() and @c PROFILE_END() 
+ *           macros. All regions are kept in a linked list so that
+ *           @c print_all_profiles() can print a table of them.
+ *
+ *           A region should be measured from only one task or one ISR, as 
+ *           @c record() doesn't turn interrupts off. The table is copied inside a 
+ *           critical section, one region at a time, before it's printed.
+ *
+ *  \section Usage
+ *  @code
+ *  PROFILE_REGION (prof_pwm, "motor pwm");
+ *  ...
+ *  uint8_t task_motor::calc_pwm (int8_t pwm)
+ *  {
+ *      PROFILE_SCOPE (prof_pwm);           // Times the rest of this function
+ *      ...
+ *  }
+ *  ...
+ *  ISR (TIMER3_CAPT_vect)
+ *  {
+ *      PROFILE_BEGIN (prof_capture);
+ *      ...
+ *      PROFILE_END (prof_capture);
+ *  }
+ *  @endcode
+ */
+
+class profile_region
+{
+	// This protected data can only be accessed from this class or its descendents
+	protected:
+		const char* p_name;                 ///< The region's name, in program memory
+		uint32_t runs;                      ///< How many times the region has run
+		uint32_t shortest;                  ///< Shortest run time in microseconds
+		uint32_t longest;                   ///< Longest run time in microseconds
+		uint16_t histogram[PROFILE_BUCKETS];    ///< Runs counted by length
+
+		/** This pointer points to the region created before this one, or is @c NULL
+		 *  if this region was the first one created.
+		 */
+		profile_region* p_next;
+
+		/** This @c static pointer, shared by all regions, points to the most recently
+		 *  created region. It begins the linked list of regions.
+		 */
+		static profile_region* p_newest;
+
+	// Public methods can be called from anywhere in the program where there is a
+	// pointer or reference to an object of this class
+	public:
+		// The constructor saves the name and puts the region in the list of regions
+		profile_region (const char* p_pgm_name);
+
+		// Count one run of the region which took the given number of microseconds
+		void record (uint32_t duration);
+
+		// Clear the measurements so that a new set can be made
+		void reset (void);
+
+		// Print a line showing this region's measurements
+		void print_in_list (emstream* p_ser_dev);
+
+	// The functions which go through all the regions need the list's beginning
+	friend void print_all_profiles (emstream* p_ser_dev);
+	friend void reset_all_profiles (void);
+};
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Measures the time from its creation until it goes out of scope.
+ *  @details A probe is made at the top of a block of code, usually by the 
+ *           @c PROFILE_SCOPE() macro. It reads the clock when it's made and, when the
+ *           block is left by any route, records the time taken in its region.
+ */
+
+class profile_probe
+{
+	// This protected data can only be accessed from this class or its descendents
+	protected:
+		profile_region* p_region;           ///< The region being measured
+		uint32_t begun;                     ///< The time at which the region began
+
+	// Public methods can be called from anywhere in the program where there is a
+	// pointer or reference to an object of this class
+	public:
+		/** This constructor reads the clock at the beginning of a region.
+		 *  @param region The region which is to be measured
+		 */
+		profile_probe (profile_region& region)
+		{
+			p_region = &region;
+			begun = profile_now ();
+		}
+
+		/** This destructor reads the clock at the end of the region and records how
+		 *  long the region took.
+		 */
+		~profile_probe (void)
+		{
+			p_region->record (profile_now () - begun);
+		}
+};
+
+
+/** @brief   Macros which declare and measure profiled regions.
+ *  @details @c PROFILE_REGION(region, name) declares a region at file scope; its 
+ *           name string is kept in program memory. @c PROFILE_SCOPE(region) measures
+ *           from where it's used to the end of the enclosing block. 
+ *           @c PROFILE_BEGIN(region) and @c PROFILE_END(region) mark the beginning 
+ *           and end of a region within one block, which suits ISRs. If 
+ *           @c TASK_PROFILE isn't defined, none of them produce any code or data.
+ */
+#ifdef TASK_PROFILE
+	#define PROFILE_REGION(region, name) \
+		static const char region##_name[] PROGMEM = name; \
+		profile_region region (region##_name)
+	#define PROFILE_SCOPE(region)   profile_probe region##_probe (region)
+	#define PROFILE_BEGIN(region)   uint32_t region##_begun = profile_now ()
+	#define PROFILE_END(region)     region.record (profile_now () - region##_begun)
+#else
+	#define PROFILE_REGION(region, name) extern const char region##_name[]
+	#define PROFILE_SCOPE(region)
+	#define PROFILE_BEGIN(region)
+	#define PROFILE_END(region)
+#endif
+
+
+// Print a table of all the profiled regions' measurements
+void print_all_profiles (emstream* p_ser_dev);
+
+// Clear the measurements of all the profiled regions
+void reset_all_profiles (void);
+
+#endif  // _PROFILER_H_
@@ -0,0 +1,350 @@
+//*************************************************************************************
+/** @file    seqshare.h
+ *  @brief   Data shared between tasks and ISR's without disabling interrupts.
+ *  @details This file contains a template class for shared data items which are 
+ *           protected by a sequence counter rather than by critical sections. Readers
+ *           copy the data and check the counter to see if it was changed during the 
+ *           copy, trying again if so, and the writer never waits for readers. This 
+ *           lets multi-byte items and structures be shared without shutting off 
+ *           interrupts for the duration of each copy.
+ *
+ *  Revised:
+ *    \li 10-17-2026 AG  Original file
+ *    \li 10-17-2026 AG  Added @c get_if_changed() using the sequence counter
+ *    \li 10-17-2026 AG  Readers check a write-started counter, so a write begun
+ *                       during a copy can't go unnoticed
+ *
+ *  License:
+ *		This file is copyright 2026 by agent (AG) and released under the Lesser GNU 
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _SEQSHARE_H_
+#define _SEQSHARE_H_
+
+#include <string.h>                         // C language string handling functions
+#include "FreeRTOS.h"                       // Main header for FreeRTOS
+#include "baseshare.h"                      // Base class for shared data items
+#include "taskbase.h"                       // Tasks which can be woken by a share
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Class for data shared between tasks and ISR's with a sequence counter.
+ *  @details This class holds two copies of the shared data and two one-byte counters.
+ *           The sequence counter counts finished writes, and the newest data is in 
+ *           the buffer whose index is its low bit. The started counter counts writes
+ *           which have begun. A writer sets the started counter to the number of the
+ *           write it's beginning, puts new data into the @e other buffer, then sets 
+ *           the sequence counter to the same number; each is a single uninterruptible
+ *           store on an AVR. A reader notes the sequence counter, copies the buffer it
+ *           points to, and then looks at the started counter. If a second write has
+ *           begun since the one whose data was copied, that write uses the buffer
+ *           being copied, so the copy may be a mixture of old and new data and the 
+ *           reader tries again; otherwise the copy is good. 
+ * 
+ *           Because the writer never writes the buffer holding the newest data, a 
+ *           reader never has to wait for a writer to finish, even if the writer is a
+ *           lower priority task which was preempted in the middle of a write. Nothing
+ *           disables interrupts, so a @c SeqShare can hold a large structure without
+ *           affecting interrupt latency. A reader only has to retry if, while it was
+ *           copying, one write finished and another began; this can happen when the
+ *           reader is interrupted or preempted, including by a writer of the same 
+ *           priority when tasks take turns.
+ * 
+ *           There must be only @b one writer, which can be a task or an ISR. If data
+ *           must be written from more than one place, use a @c TaskShare instead. Any
+ *           number of tasks and ISR's can read. 
+ * 
+ *  @section Usage
+ *  A @c SeqShare is used like a @c TaskShare. In this example, an ISR measures a 
+ *  pulse width and a task reads it:
+ *  @code
+ *  SeqShare<uint16_t>* p_width;                   // In main.cpp, global
+ *  ...
+ *  p_width = new SeqShare<uint16_t> ("Width");    // In main()
+ *  ...
+ *  p_width->ISR_put (TCNT3);                      // In the ISR
+ *  ...
+ *  uint16_t width = p_width->get ();              // In the task
+ *  @endcode
+ */
+
+template <class DataType> class SeqShare : public BaseShare
+{
+	protected:
+		/// These buffers hold the newest and the next-to-newest copies of the data.
+		DataType buffers[2];
+
+		/** This counter is incremented each time data is written. Its lowest bit is 
+		 *  the index of the buffer which holds the newest data. 
+		 */
+		volatile uint8_t sequence;
+
+		/** This counter is set to the number of each write as the write begins, 
+		 *  before any data is copied. When no write is going on, it's equal to 
+		 *  @c sequence.
+		 */
+		volatile uint8_t started;
+
+		/// This is the number of times data has been written into the share.
+		uint32_t writes;
+
+		/// This is the number of times a reader had to copy the data again.
+		uint32_t retries;
+
+		/** @brief   Pointer to a task which is woken up when the data is changed.
+		 *  @details If this pointer isn't @c NULL, the task to which it points is 
+		 *           woken up each time new data is put into the share.
+		 */
+		TaskBase* p_subscriber;
+
+		// This method copies new data into the share and publishes it
+		void write (const DataType& new_data);
+
+		// This method copies the newest data out of the share
+		DataType read (void);
+
+	public:
+		/** @brief   Construct a sequence counted shared data item.
+		 *  @details This constructor sets the sequence counter and the statistics to
+		 *           zero. As with a @c TaskShare, the data is @b not initialized.
+		 *  @param   p_name A name to be shown in the list of task shares
+		 */
+		SeqShare<DataType> (const char* p_name) : BaseShare (p_name)
+		{
+			sequence = 0;
+			started = 0;
+			writes = 0;
+			retries = 0;
+			p_subscriber = NULL;
+		}
+
+		/** @brief   Have the given task woken up whenever data is put into the share.
+		 *  @details This method works just like @c TaskShare::subscribe().
+		 *  @param   p_task Pointer to the task to wake up, or @c NULL for none
+		 */
+		void subscribe (TaskBase* p_task)
+		{
+			p_subscriber = p_task;
+		}
+
+		/** @brief   Put data into the shared data item from a task.
+		 *  @details This method writes new data into the share. It never disables 
+		 *           interrupts and never waits for a reader.
+		 *  @param   new_data The data which is to be written
+		 */
+		void put (const DataType& new_data)
+		{
+			write (new_data);
+			if (p_subscriber != NULL)
+			{
+				p_subscriber->wake ();
+			}
+		}
+
+		/** @brief   Put data into the shared data item from within an ISR.
+		 *  @details This method writes new data into the share from an interrupt 
+		 *           service routine. The write itself is the same as in @c put(); 
+		 *           only the waking of a subscribed task differs.
+		 *  @param   new_data The data which is to be written
+		 */
+		void ISR_put (const DataType& new_data)
+		{
+			write (new_data);
+			if (p_subscriber != NULL)
+			{
+				p_subscriber->ISR_wake ();
+			}
+		}
+
+		/** @brief   Read data from the shared data item.
+		 *  @details This method reads the newest data from the share. It can be used
+		 *           from within a task or an ISR. 
+		 *  @return  A copy of the newest data in the share
+		 */
+		DataType get (void)
+		{
+			return (read ());
+		}
+
+		/** @brief   Read data from the shared data item, from within an ISR.
+		 *  @details This method is the same as @c get(); it's here so that a 
+		 *           @c SeqShare can be used in place of a @c TaskShare.
+		 *  @return  A copy of the newest data in the share
+		 */
+		DataType ISR_get (void)
+		{
+			return (read ());
+		}
+
+		// This method reads the data only if it has changed since it was last read
+		bool get_if_changed (DataType& data, share_version_t& last_version);
+
+		/** @brief   Return the version number of the data in the share.
+		 *  @details The sequence counter serves as the version number; it goes up by
+		 *           one each time data is written, as in a @c TaskShare.
+		 *  @return  The current version number of the data
+		 */
+		share_version_t get_version (void)
+		{
+			return (sequence);
+		}
+
+		/** @brief   Return the number of times data has been written into the share.
+		 *  @return  The number of writes since the share was created
+		 */
+		uint32_t get_writes (void)
+		{
+			return (writes);
+		}
+
+		/** @brief   Return the number of times a reader had to read the data again.
+		 *  @details This count isn't protected, so if an ISR and a task both have to
+		 *           retry at the same moment, it could miss one. 
+		 *  @return  The number of retries since the share was created
+		 */
+		uint32_t get_retries (void)
+		{
+			return (retries);
+		}
+
+		// Print the share's status within a list of all shares' statuses
+		void print_in_list (emstream* p_ser_dev);
+}; // class SeqShare<DataType>
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Copy new data into the share and publish it.
+ *  @details This method marks the write as started, copies the data into the buffer
+ *           which doesn't hold the newest data, then increments the sequence counter
+ *           so that readers will use the buffer just written. The barriers make sure 
+ *           the compiler doesn't move the copy before the started counter is set or
+ *           after the sequence counter is changed.
+ *  @param   new_data The data which is to be written
+ */
+
+template <class DataType>
+inline void SeqShare<DataType>::write (const DataType& new_data)
+{
+	uint8_t next = sequence + 1;
+
+	started = next;
+	SHARE_BARRIER ();
+	buffers[next & 0x01] = new_data;
+	SHARE_BARRIER ();
+	sequence = next;
+	writes++;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Copy the newest data out of the share.
+ *  @details This method copies the buffer holding the newest data, then checks the 
+ *           started counter. If at most one write has begun since the copied data 
+ *           was written, the writer has only touched the other buffer and the copy is
+ *           fine. If two or more have begun, the buffer being copied might have been
+ *           changed part way through, so the copy is made again. 
+ *  @return  A copy of the newest data in the share
+ */
+
+template <class DataType>
+DataType SeqShare<DataType>::read (void)
+{
+	DataType copy;                          // Copy of the data to be returned
+	uint8_t seq_before;                     // Sequence counter before copying
+
+	for (;;)
+	{
+		seq_before = sequence;
+		SHARE_BARRIER ();
+		copy = buffers[seq_before & 0x01];
+		SHARE_BARRIER ();
+		if ((uint8_t)(started - seq_before) < 2)
+		{
+			return (copy);
+		}
+		retries++;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Read data from the share only if it has changed.
+ *  @details This method works like @c TaskShare::get_if_changed(), using the sequence
+ *           counter as the version number. If the counter differs from the version 
+ *           the caller last saw, the newest data is copied and the version it came 
+ *           from is given back. No critical section is needed; the copy is retried
+ *           just as in @c get().
+ *  @param   data A reference to a variable into which new data will be copied
+ *  @param   last_version A reference to the version number which the caller last 
+ *           saw; it is updated when new data is copied
+ *  @return  @c true if new data was copied, @c false if the data hasn't changed
+ */
+
+template <class DataType>
+bool SeqShare<DataType>::get_if_changed (DataType& data, 
+										 share_version_t& last_version)
+{
+	uint8_t seq_before;                     // Sequence counter before copying
+
+	for (;;)
+	{
+		seq_before = sequence;
+		if (seq_before == last_version)
+		{
+			return (false);
+		}
+		SHARE_BARRIER ();
+		data = buffers[seq_before & 0x01];
+		SHARE_BARRIER ();
+		if ((uint8_t)(started - seq_before) < 2)
+		{
+			last_version = seq_before;
+			return (true);
+		}
+		retries++;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Print the status of this share within a list of all shares.
+ *  @details This method prints the share's name, its type, and the numbers of writes
+ *           and of read retries, then asks the next share in the list to do the same.
+ *  @param   p_ser_dev Pointer to a serial device on which to print the status
+ */
+
+template <class DataType>
+void SeqShare<DataType>::print_in_list (emstream* p_ser_dev)
+{
+	// Print this share's name and pad it to 16 characters
+	*p_ser_dev << name;
+	for (uint8_t cols = strlen (name); cols < 16; cols++)
+	{
+		p_ser_dev->putchar (' ');
+	}
+
+	// Show how many writes there have been and how often readers had to retry
+	*p_ser_dev << PMS ("seq\t") << writes << PMS (" wr, ") << retries << PMS (" retry")
+			   << endl;
+
+	// Call the next item
+	if (p_next != NULL)
+	{
+		p_next->print_in_list (p_ser_dev);
+	}
+}
+
+#endif  // _SEQSHARE_H_
@@ -10,6 +10,7 @@
  *    \li 10-21-2012 JRR Original file
  *    \li 08-25-2012 JRR Modified to run with STM32's as well as AVR's
  *    \li 08-26-2014 JRR Changed file names and base task class name to TaskBase
+ *    \li 10-17-2026 AG  Added @c enable_wakeups() for event driven tasks
  *
  *  Credits:
  *      This code uses techniques learned from Amigo software, which is copyright 2012 
@@ -112,6 +113,15 @@ TaskBase::TaskBase (const char* a_name, unsigned portBASE_TYPE a_priority,
 	// Initialize the run counter
 	runs = 0;
 
+	// Wakeups are off until the task asks for them with enable_wakeups()
+	wakeup_sema = NULL;
+	wakeups = 0;
+	idle_timeouts = 0;
+
+	#if (configGENERATE_RUN_TIME_STATS == 1)
+		prev_run_time = 0;
+	#endif
+
 	// If the serial port is being used, let the user know if the task was created
 	// successfully
 	if (p_serial != NULL)
@@ -207,6 +217,34 @@ void TaskBase::transition_to (uint8_t new_state)
 }
 
 
+//-------------------------------------------------------------------------------------
+/** @brief   Allow this task to be woken up by shares, other tasks, and ISR's.
+ *  @details This method creates the binary semaphore which @c wake() and 
+ *           @c ISR_wake() give and @c wait_for_wakeup() takes. Once it has been 
+ *           called, a task can sleep in @c wait_for_wakeup() instead of polling its
+ *           inputs every tick, and shares to which the task has subscribed will wake
+ *           it whenever new data is put into them. Calling this method more than 
+ *           once does no harm. 
+ *  @return  @c true if wakeups are enabled, @c false if there was no memory for them
+ */
+
+bool TaskBase::enable_wakeups (void)
+{
+	if (wakeup_sema == NULL)
+	{
+		wakeup_sema = xSemaphoreCreateBinary ();
+
+		if (wakeup_sema == NULL && p_serial != NULL)
+		{
+			*p_serial << PMS ("ERROR creating wakeup for task \"") << get_name ()
+					  << '"' << endl;
+		}
+	}
+
+	return (wakeup_sema != NULL);
+}
+
+
 //-------------------------------------------------------------------------------------
 /** @brief   Print an error message if possible and reset the processor.
  *  @details This method prints an error message (if there is a valid serial device 
@@ -11,6 +11,10 @@
  *    \li 08-25-2012 JRR Modified to run with STM32's as well as AVR's
  *    \li 08-26-2014 JRR Changed file names and base task class name to TaskBase
  *    \li 09-03-2014 JRR Minor upgrades; renamed method to @c delay_from_for()
+ *    \li 10-17-2026 AG  Added optional event wakeups so tasks can block until a
+ *                       share they read has been changed
+ *    \li 10-17-2026 AG  Added processor load from FreeRTOS run time statistics
+ *    \li 10-17-2026 AG  Added @c delay_us() for delays shorter than an RTOS tick
  *
  *  Credits:
  *      Much of this code uses techniques learned from Amigo software, which is 
@@ -41,10 +45,12 @@
 #ifdef __AVR
 	#include <avr/wdt.h>                    // Header for watchdog timer that reboots
 	#include "time_stamp.h"                 // Header for timekeeping class
+	#include "delay_us.h"                   // Delays timed by the hardware timer
 #endif
 
 #include "FreeRTOS.h"                       // Main header for FreeRTOS
 #include "task.h"                           // Header for FreeRTOS tasks
+#include "semphr.h"                         // Semaphores used for task wakeups
 
 #include "mechutil.h"                       // Utility functions for the ME405 code
 #include "emstream.h"                       // Pull in the base class header file
@@ -270,6 +276,31 @@ class TaskBase
 		 */
 		uint32_t runs;
 
+		/** This is a binary semaphore which other tasks and ISR's give in order to 
+		 *  wake this task up when something it cares about has changed. It is 
+		 *  @c NULL unless @c enable_wakeups() has been called, so tasks which just
+		 *  poll don't pay for it in RAM.
+		 */
+		SemaphoreHandle_t wakeup_sema;
+
+		/** This variable counts the number of times @c wait_for_wakeup() returned
+		 *  because the task was woken by a change in one of its inputs.
+		 */
+		uint32_t wakeups;
+
+		/** This variable counts the number of times @c wait_for_wakeup() returned
+		 *  because the timeout expired with nobody having woken the task up.
+		 */
+		uint32_t idle_timeouts;
+
+		#if (configGENERATE_RUN_TIME_STATS == 1)
+			/** This is the task's FreeRTOS run time counter as it was when the task
+			 *  list was last printed. It's used to find the load on the processor
+			 *  due to this task since then.
+			 */
+			uint32_t prev_run_time;
+		#endif
+
 		/** This method allows descendent classes to find out how many times the
 		 *  @c loop() method has run.
 		 *  @return The number of times the loop has been run
@@ -445,6 +476,22 @@ class TaskBase
             vTaskDelayUntil (&from_ticks, ticks);
         }
 
+		#ifdef __AVR
+		/** @brief   Stop the task for the given number of microseconds.
+		 *  @details This method delays the task for a time which may be much shorter
+		 *           than an RTOS tick. Unless the delay is very short, the task 
+		 *           sleeps and is woken by a hardware timer interrupt at the end of
+		 *           the delay, so other tasks can run meanwhile; see @c ::delay_us().
+		 *           Like @c delay_ms(), it shouldn't be used to run a task at regular
+		 *           intervals.
+		 *  @param   duration_us The duration for the task to stop in microseconds
+		 */
+		void delay_us (uint32_t duration_us)
+		{
+			::delay_us (duration_us);
+		}
+		#endif
+
 		/** @brief   Find out how many RTOS ticks since the scheduler was started.
 		 *  @details This method returns the number of RTOS ticks from the time the
 		 *           scheduler was started up until the time the method is called. By
@@ -611,6 +658,72 @@ class TaskBase
 			return (handle);
 		}
 
+		// Make this task able to be woken up by shares and other tasks
+		bool enable_wakeups (void);
+
+		/** @brief   Wait until this task is woken up or a timeout expires.
+		 *  @details This method blocks the task until another task calls @c wake() or
+		 *           an ISR calls @c ISR_wake(), usually from within the @c put() or
+		 *           @c ISR_put() method of a share to which this task has subscribed.
+		 *           If nothing happens within the given number of RTOS ticks, the 
+		 *           method returns anyway so that the task can do periodic work. 
+		 *           Several wakeups which occur while the task is busy are merged
+		 *           into one. If wakeups haven't been enabled for this task with
+		 *           @c enable_wakeups(), this method just delays for the timeout.
+		 *  @param   timeout The longest time to wait, in RTOS ticks
+		 *  @return  @c true if the task was woken up, @c false if the time ran out
+		 */
+		bool wait_for_wakeup (TickType_t timeout)
+		{
+			if (wakeup_sema == NULL)
+			{
+				vTaskDelay (timeout);
+			}
+			else if (xSemaphoreTake (wakeup_sema, timeout) == pdTRUE)
+			{
+				wakeups++;
+				return (true);
+			}
+			idle_timeouts++;
+			return (false);
+		}
+
+		/** @brief   Wake this task up if it is waiting in @c wait_for_wakeup().
+		 *  @details This method is called from another task to tell this task that 
+		 *           something it is interested in has changed. If wakeups have not
+		 *           been enabled for this task, nothing happens. This method must 
+		 *           @b not be called from within an ISR; use @c ISR_wake() there.
+		 */
+		void wake (void)
+		{
+			if (wakeup_sema != NULL)
+			{
+				xSemaphoreGive (wakeup_sema);
+			}
+		}
+
+		/** @brief   Wake this task up from within an interrupt service routine.
+		 *  @details This method is the ISR version of @c wake(). The AVR port of 
+		 *           FreeRTOS can't yield from within an ISR, so the woken task will
+		 *           run at the next RTOS tick or the next time the running task 
+		 *           blocks, whichever comes first.
+		 */
+		void ISR_wake (void)
+		{
+			if (wakeup_sema != NULL)
+			{
+				xSemaphoreGiveFromISR (wakeup_sema, NULL);
+			}
+		}
+
+		/** @brief   Return the number of times this task has been woken by an event.
+		 *  @return  The number of wakeups which did not result from a timeout
+		 */
+		uint32_t get_wakeups (void)
+		{
+			return (wakeups);
+		}
+
 		// Print the status of this task
 		virtual void print_status (emstream&);
 
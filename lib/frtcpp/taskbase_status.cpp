@@ -8,6 +8,8 @@
  *    \li 12-02-2012 JRR Split off from time_stamp.cpp to save memory in machine file
  *    \li 08-26-2014 JRR Changed file names and base task class name to TaskBase
  *    \li 01-04-2015 JRR Moved items around for more efficient use of screen space
+ *    \li 10-17-2026 AG  Added run time and processor load columns to the task list
+ *    \li 10-17-2026 AG  Task status array for run times is static, not on the heap
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -27,6 +29,73 @@
 
 #include <string.h>                         // For strlen() and Sparta (the Mean Kitty)
 #include "taskbase.h"                       // Pull in the base class header file
+#include "time_stamp.h"                     // For the run time counter's rate
+
+
+#if (configGENERATE_RUN_TIME_STATS == 1)
+	/** This is the largest number of tasks, counting the idle task, whose run times
+	 *  can be shown in the task list. If there are more tasks than this, the kernel
+	 *  won't fill in the status array and the run time columns show dashes. It may be
+	 *  changed with a @c -D option in the Makefile.
+	 */
+	#ifndef RUN_STATS_MAX_TASKS
+		#define RUN_STATS_MAX_TASKS     10
+	#endif
+
+	/** This array of task status structures is filled in by the kernel while the task
+	 *  list is being printed. It's kept in static memory rather than being allocated
+	 *  each time the list is printed, as that would fragment the heap over time.
+	 */
+	static TaskStatus_t run_stats[RUN_STATS_MAX_TASKS];
+
+	/// This is the number of task status structures in @c run_stats which are valid.
+	static UBaseType_t num_run_stats = 0;
+
+	/// This is the run time which has elapsed since the task list was last printed.
+	static uint32_t run_time_elapsed = 0;
+
+	/// This is the total run time counter as it was when the task list was printed.
+	static uint32_t prev_total_run_time = 0;
+
+	/// This is the idle task's run time counter when the task list was printed.
+	static uint32_t prev_idle_run_time = 0;
+
+
+	//---------------------------------------------------------------------------------
+	/** This function prints the total time a task has run in milliseconds and the 
+	 *  percentage of processor time it has used since the task list was last printed.
+	 *  It can only find the task's run time while @c print_task_list() is running; at 
+	 *  other times it prints dashes. 
+	 *  @param ser_dev A reference to the serial device on which to print
+	 *  @param a_task The handle of the task whose run time is to be printed
+	 *  @param prev_time A reference to the task's run time counter as it was when 
+	 *                   the task list was last printed; it is updated here
+	 */
+
+	static void print_run_time (emstream& ser_dev, TaskHandle_t a_task, 
+								uint32_t& prev_time)
+	{
+		uint32_t run_time;                  // The task's run time counter
+
+		for (UBaseType_t index = 0; index < num_run_stats; index++)
+		{
+			if (run_stats[index].xHandle == a_task)
+			{
+				run_time = run_stats[index].ulRunTimeCounter;
+				ser_dev << PMS ("\t") << run_time / (RUN_TIME_RATE_HZ / 1000UL)
+						<< PMS ("\t");
+				if (run_time_elapsed >= 100)
+				{
+					ser_dev << (run_time - prev_time) / (run_time_elapsed / 100UL);
+				}
+				ser_dev << '%';
+				prev_time = run_time;
+				return;
+			}
+		}
+		ser_dev << PMS ("\t-\t-");
+	}
+#endif // configGENERATE_RUN_TIME_STATS
 
 
 //-------------------------------------------------------------------------------------
@@ -69,6 +138,20 @@ void TaskBase::print_status (emstream& ser_dev)
 			<< (size_t)(get_total_stack ()) << PMS ("\t")
 		#endif
 			<< PMS ("\t") << runs;
+
+	// Tasks which are woken by events show how often they woke vs. timed out
+	if (wakeup_sema != NULL)
+	{
+		ser_dev << PMS ("\t") << wakeups << PMS ("/") << idle_timeouts;
+	}
+	else
+	{
+		ser_dev << PMS ("\t-");
+	}
+
+	#if (configGENERATE_RUN_TIME_STATS == 1)
+		print_run_time (ser_dev, handle, prev_run_time);
+	#endif
 }
 
 
@@ -104,6 +187,17 @@ emstream& operator << (emstream& ser_dev, TaskBase& a_task)
 
 void print_task_list (emstream* ser_dev)
 {
+	// Get the run time of every task from the kernel, and find out how much time has
+	// passed since the list was last printed so that the load can be computed
+	#if (configGENERATE_RUN_TIME_STATS == 1)
+		uint32_t total_run_time = prev_total_run_time;
+
+		num_run_stats = uxTaskGetSystemState (run_stats, RUN_STATS_MAX_TASKS, 
+											  &total_run_time);
+		run_time_elapsed = total_run_time - prev_total_run_time;
+		prev_total_run_time = total_run_time;
+	#endif
+
 	// Print the first line with the top of the headings
 	*ser_dev << PMS ("Task\t\t  \t ")
 		#if (INCLUDE_uxTaskGetStackHighWaterMark == 1)
@@ -116,14 +210,22 @@ void print_task_list (emstream* ser_dev)
 		#if (INCLUDE_uxTaskGetStackHighWaterMark == 1)
 			<< PMS ("\tFree/Total")
 		#endif
-			<< PMS ("\tRuns") << endl;
+			<< PMS ("\tRuns\tWake/Idle")
+		#if (configGENERATE_RUN_TIME_STATS == 1)
+			<< PMS ("\tCPU ms\tLoad")
+		#endif
+			<< endl;
 
 	// Print the third line which shows separators between headers and data
 	*ser_dev << PMS ("----\t\t----\t-----")
 		#if (INCLUDE_uxTaskGetStackHighWaterMark == 1)
 			<< PMS ("\t----------")
 		#endif
-			<< PMS ("\t----") << endl;
+			<< PMS ("\t----\t---------")
+		#if (configGENERATE_RUN_TIME_STATS == 1)
+			<< PMS ("\t------\t----")
+		#endif
+			<< endl;
 
 	// Now have the tasks each print out their status. Tasks form a linked list, so
 	// we only need to get the last task started and it will call the next, etc.
@@ -138,6 +240,13 @@ void print_task_list (emstream* ser_dev)
 			<< uxTaskGetStackHighWaterMark (xTaskGetIdleTaskHandle ())
 			<< PMS ("/") << configMINIMAL_STACK_SIZE << PMS ("\t\t-")
 		#endif
-			<< endl;
+			<< PMS ("\t-");
+
+	// The idle task's load is the part of the processor's time that's left over
+	#if (configGENERATE_RUN_TIME_STATS == 1)
+		print_run_time (*ser_dev, xTaskGetIdleTaskHandle (), prev_idle_run_time);
+		num_run_stats = 0;
+	#endif
+	*ser_dev << endl;
 }
 
@@ -6,6 +6,9 @@
  *  Revised:
  *    \li 10-21-2012 JRR Original file
  *    \li 08-26-2014 JRR Changed file names and queue class name to Queue
+ *    \li 10-17-2026 AG  Added @c put_n(), @c get_n(), @c drain_into() for batches
+ *    \li 10-17-2026 AG  Batches copied in a critical section, not with the scheduler
+ *                       suspended; ISR batch methods yield to a task they wake
  *
  *  License:
  *		This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -76,6 +79,16 @@
  *  method @c get_handle() to retrieve the handle used by the C language functions in
  *  FreeRTOS to access the TaskQueue object's underlying data structure directly. 
  * 
+ *  When many items are to be moved at once, as with a stream of sensor samples, the
+ *  batch methods @c put_n(), @c get_n() and @c drain_into() can be used. They move
+ *  a whole array of items in one critical section, so the RTOS doesn't switch to a
+ *  task which was waiting for the queue after each item; if a task was woken, it runs
+ *  once when the batch is done. FreeRTOS has no function which copies many items into
+ *  a queue at once, so the items are copied one at a time by the queue functions 
+ *  meant for ISR's, which may be called with interrupts off. The methods 
+ *  @c ISR_put_n() and @c ISR_drain_into() do the same within an interrupt service
+ *  routine. 
+ * 
  *  @section Usage
  *  The following bits of code show how to set up and use a queue to transfer data of
  *  type @c uint16_t 
@@ -195,9 +208,24 @@ template <class dataType> class TaskQueue : public BaseShare
 			return (uxQueueMessagesWaitingFromISR (handle) == 0);
 		}
 
+		// Put an array of items into the back of the queue
+		uint16_t put_n (const dataType* p_items, uint16_t count);
+
+		// Put an array of items into the back of the queue from within an ISR
+		uint16_t ISR_put_n (const dataType* p_items, uint16_t count);
+
 		// Get an item from the queue
 		dataType get (void);
 
+		// Get a given number of items from the queue, waiting for them if needed
+		uint16_t get_n (dataType* p_items, uint16_t count);
+
+		// Get all the items which are in the queue without waiting for more
+		uint16_t drain_into (dataType* p_items, uint16_t max_count);
+
+		// Get all the items in the queue without waiting, from within an ISR
+		uint16_t ISR_drain_into (dataType* p_items, uint16_t max_count);
+
 		// Get an item from the queue from within an interrupt service routine
 		dataType ISR_get (void);
 
@@ -334,6 +362,207 @@ inline dataType TaskQueue<dataType>::get (void)
 }
 
 
+//-------------------------------------------------------------------------------------
+/** @brief   Put an array of items into the back of the queue.
+ *  @details This method puts @c count items into the queue, in order. As many items
+ *           as will fit are copied in one critical section with the queue functions
+ *           meant for ISR's, since the regular ones mustn't be called while the 
+ *           scheduler is suspended and would switch tasks part way through. A task
+ *           which is waiting for the data is switched to once, after the batch. 
+ *           Interrupts are off while the batch is copied, so batches should be kept
+ *           short. If the queue fills up, this method waits for space the same way as
+ *           @c put() does, then carries on with the rest of the batch. This method 
+ *           must \b not be used within an ISR.
+ *  @param   p_items Pointer to an array of items to be put into the queue
+ *  @param   count The number of items in the array
+ *  @return  The number of items which were put into the queue; this is less than
+ *           @c count only if the wait for space in the queue timed out
+ */
+
+template <class dataType>
+uint16_t TaskQueue<dataType>::put_n (const dataType* p_items, uint16_t count)
+{
+	uint16_t done = 0;                      // Number of items put into the queue
+	signed portBASE_TYPE task_awakened;     // Checks if a context switch is needed
+
+	while (done < count)
+	{
+		// Copy as many items as will fit without waiting for space, then let a task
+		// which was waiting for the data run if it's more important than this one
+		task_awakened = pdFALSE;
+		portENTER_CRITICAL ();
+		while (done < count 
+			   && xQueueSendToBackFromISR (handle, p_items + done, &task_awakened) 
+				  == pdTRUE)
+		{
+			done++;
+		}
+		portEXIT_CRITICAL ();
+		if (task_awakened == pdTRUE)
+		{
+			taskYIELD ();
+		}
+
+		// If the queue is full, wait for room for the next item just as put() does
+		if (done < count)
+		{
+			if (xQueueSendToBack (handle, p_items + done, ticks_to_wait) != pdTRUE)
+			{
+				break;
+			}
+			done++;
+		}
+	}
+
+	return (done);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Put an array of items into the back of the queue from within an ISR.
+ *  @details This method puts as many of the given items into the queue as will fit. 
+ *           An ISR can't wait, so the items which don't fit are not queued. If a 
+ *           task which is more important than the interrupted one was waiting for the
+ *           data, it's switched to when the ISR returns. It must \b not be used 
+ *           within non-ISR code. 
+ *  @param   p_items Pointer to an array of items to be put into the queue
+ *  @param   count The number of items in the array
+ *  @return  The number of items which were put into the queue
+ */
+
+template <class dataType>
+uint16_t TaskQueue<dataType>::ISR_put_n (const dataType* p_items, uint16_t count)
+{
+	// This value is set to true if a context switch should occur due to this data
+	signed portBASE_TYPE shouldSwitch = pdFALSE;
+
+	uint16_t done = 0;                      // Number of items put into the queue
+
+	while (done < count 
+		   && xQueueSendToBackFromISR (handle, p_items + done, &shouldSwitch) == pdTRUE)
+	{
+		done++;
+	}
+
+	// The AVR port has no taskYIELD_FROM_ISR(); as in the FreeRTOS AVR demos, an ISR
+	// calls taskYIELD(), which saves the ISR's registers with the interrupted task
+	if (shouldSwitch == pdTRUE)
+	{
+		taskYIELD ();
+	}
+
+	return (done);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Get a given number of items from the queue.
+ *  @details This method fills the given array with @c count items from the queue. 
+ *           The items already in the queue are taken in one batch, as in 
+ *           @c drain_into(); if there aren't enough, the calling task blocks until 
+ *           more items arrive, as it would in @c get(). This method must \b not be
+ *           used within an ISR.
+ *  @param   p_items Pointer to an array into which items will be copied
+ *  @param   count The number of items to get; the array must have room for them
+ *  @return  The number of items copied, which is always @c count
+ */
+
+template <class dataType>
+uint16_t TaskQueue<dataType>::get_n (dataType* p_items, uint16_t count)
+{
+	uint16_t done = 0;                      // Number of items taken from the queue
+
+	while (done < count)
+	{
+		done += drain_into (p_items + done, count - done);
+
+		// If the queue ran dry, wait for the next item just as get() does
+		if (done < count)
+		{
+			xQueueReceive (handle, p_items + done, portMAX_DELAY);
+			done++;
+		}
+	}
+
+	return (done);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Get all the items which are in the queue without waiting for more.
+ *  @details This method copies items from the queue into the given array until the
+ *           queue is empty or the array is full. The items are copied in one critical
+ *           section with the queue functions meant for ISR's, which unlike the regular
+ *           ones may be used while nothing else can run; a task waiting for space in
+ *           the queue is switched to once, after the batch. Interrupts are off while
+ *           the batch is copied, so batches should be kept short. It never blocks, 
+ *           and it must \b not be used within an ISR.
+ *  @param   p_items Pointer to an array into which items will be copied
+ *  @param   max_count The largest number of items which the array can hold
+ *  @return  The number of items which were copied, which may be zero
+ */
+
+template <class dataType>
+uint16_t TaskQueue<dataType>::drain_into (dataType* p_items, uint16_t max_count)
+{
+	uint16_t done = 0;                      // Number of items taken from the queue
+
+	// This is set to true if a context switch should occur due to the batch
+	signed portBASE_TYPE task_awakened = pdFALSE;
+
+	portENTER_CRITICAL ();
+	while (done < max_count 
+		   && xQueueReceiveFromISR (handle, p_items + done, &task_awakened) == pdTRUE)
+	{
+		done++;
+	}
+	portEXIT_CRITICAL ();
+
+	if (task_awakened == pdTRUE)
+	{
+		taskYIELD ();
+	}
+
+	return (done);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Get all the items in the queue without waiting, from within an ISR.
+ *  @details This method copies items from the queue into the given array until the
+ *           queue is empty or the array is full. If a task which is more important 
+ *           than the interrupted one was waiting for space in the queue, it's 
+ *           switched to when the ISR returns. It must \b not be used within non-ISR
+ *           code. 
+ *  @param   p_items Pointer to an array into which items will be copied
+ *  @param   max_count The largest number of items which the array can hold
+ *  @return  The number of items which were copied, which may be zero
+ */
+
+template <class dataType>
+uint16_t TaskQueue<dataType>::ISR_drain_into (dataType* p_items, uint16_t max_count)
+{
+	// This is set to true if a context switch should occur due to the batch
+	signed portBASE_TYPE task_awakened = pdFALSE;
+
+	uint16_t done = 0;                      // Number of items taken from the queue
+
+	while (done < max_count 
+		   && xQueueReceiveFromISR (handle, p_items + done, &task_awakened) == pdTRUE)
+	{
+		done++;
+	}
+
+	// As in ISR_put_n(), switch to a more important task which was woken
+	if (task_awakened == pdTRUE)
+	{
+		taskYIELD ();
+	}
+
+	return (done);
+}
+
+
 //-------------------------------------------------------------------------------------
 /** @brief   Return and remove the item at the head of the queue from within an ISR.
  *  @details This method removes and returns the item at the head of the queue from 
@@ -11,6 +11,12 @@
  *    \li 08-26-2014 JRR Changed file names, class name to @c TaskShare, removed unused
  *                       version that uses semaphores, renamed @c put() and @c get()
  *    \li 10-18-2014 JRR Added linked list of all shares for tracking and debugging
+ *    \li 10-17-2026 AG  Added @c subscribe() so a share can wake a task on updates
+ *    \li 10-17-2026 AG  Single byte types are read and written without critical 
+ *                       sections, because the AVR can't be interrupted in the middle
+ *                       of a one byte load or store
+ *    \li 10-17-2026 AG  Added version numbers, @c get_if_changed(), and counts of
+ *                       updates published and used
  *
  *  License:
  *		This file is copyright 2014 by JR Ridgely and released under the Lesser GNU 
@@ -35,6 +41,33 @@
 #include <string.h>                         // C language string handling functions
 #include "FreeRTOS.h"                       // Main header for FreeRTOS
 #include "baseshare.h"                      // Base class for shared data items
+#include "taskbase.h"                       // Tasks which can be woken by a share
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Tells at compile time whether a type can be copied without protection.
+ *  @details A share of a type which the processor reads or writes with a single 
+ *           instruction needs no critical section, because an interrupt can't occur
+ *           in the middle of the copy. On an 8-bit AVR, that means one-byte types; 
+ *           this template says "no" for every type, and the specializations below 
+ *           say "yes" for the one-byte built-in types. Structures are deliberately
+ *           left out even if they are one byte long, as they can't be copied through
+ *           a @c volatile reference without an assignment operator written for it.
+ *           On a processor with a wider bus, more specializations could be added.
+ */
+
+template <class DataType> struct share_is_atomic
+{
+	/// This is @c true if a @c DataType can be copied in one uninterruptible step.
+	static const bool value = false;
+};
+
+/// @cond NO_DOXY
+template <> struct share_is_atomic<bool>          { static const bool value = true; };
+template <> struct share_is_atomic<char>          { static const bool value = true; };
+template <> struct share_is_atomic<signed char>   { static const bool value = true; };
+template <> struct share_is_atomic<unsigned char> { static const bool value = true; };
+/// @endcond
 
 
 //-------------------------------------------------------------------------------------
@@ -56,6 +89,13 @@
  *           reliably prevent data corruption; it prevents possible side effects from 
  *           causing the sender's copy of the data from being inadvertently changed. 
  * 
+ *           Data types for which @c share_is_atomic is @c true, such as @c bool, 
+ *           @c int8_t and @c uint8_t, are read and written with plain @c volatile
+ *           accesses and no critical section, as one-byte copies can't be 
+ *           interrupted halfway. The choice is made at compile time, so there is no
+ *           run time cost in checking. The increment and decrement operators still
+ *           use critical sections because they read, modify, and write the data.
+ * 
  *  @section Usage
  *  The following bits of code show how to set up and use a share to transfer data of
  *  type @c uint16_t 
@@ -92,6 +132,27 @@
  *  ...
  *  got_data = p_my_share->get ();
  *  \endcode
+ *  If the receiving task would rather sleep until the data changes than poll it, the
+ *  task calls @c enable_wakeups() and is subscribed to the share; every @c put() or
+ *  @c ISR_put() then wakes the task from @c wait_for_wakeup():
+ *  @code
+ *  p_my_share->subscribe (p_task_B);        // In main(), after creating task_B
+ *  ...
+ *  wait_for_wakeup (20);                    // In task_B's loop; 20 ticks at most
+ *  got_data = p_my_share->get ();
+ *  \endcode
+ * 
+ *  A task which only needs to act when the data changes, such as one which copies the
+ *  data to an output register, can keep the version number of the data it last used
+ *  and ask for the data only if a newer version has been put into the share:
+ *  @code
+ *  share_version_t last_version = 0;        // Task member data or static variable
+ *  ...
+ *  if (p_my_share->get_if_changed (got_data, last_version))
+ *  {
+ *      OCR1A = got_data;                    // Only touch hardware for new data
+ *  }
+ *  \endcode
  * 
  *  @b Note: In the past, ME405 students have often used task shares to save data
  *  persistently within a task. This is @b not necessary. Just use variables declared 
@@ -106,6 +167,26 @@ template <class DataType> class TaskShare : public BaseShare
 	protected:
 		DataType the_data;					///< Holds the data to be shared
 
+		/** @brief   Pointer to a task which is woken up when the data is changed.
+		 *  @details If this pointer isn't @c NULL, the task to which it points is 
+		 *           woken up each time new data is put into the share.
+		 */
+		TaskBase* p_subscriber;
+
+		/** @brief   Version number of the data, incremented each time it's written.
+		 *  @details This is one byte so that it can be read and written without a 
+		 *           critical section. It wraps around after 256 writes, so a task 
+		 *           which uses @c get_if_changed() must check for new data more
+		 *           often than that, which is easy when it runs every few ticks.
+		 */
+		volatile share_version_t version;
+
+		/// This is the number of times data has been put into the share.
+		uint32_t published;
+
+		/// This is the number of times @c get_if_changed() has returned new data.
+		uint32_t consumed;
+
 	public:
 		/** @brief   Construct a shared data item.
 		 *  @details This default constructor for a shared data item doesn't do much
@@ -116,6 +197,22 @@ template <class DataType> class TaskShare : public BaseShare
 		 */
 		TaskShare<DataType> (const char* p_name) : BaseShare (p_name)
 		{
+			p_subscriber = NULL;
+			version = 0;
+			published = 0;
+			consumed = 0;
+		}
+
+		/** @brief   Have the given task woken up whenever data is put into the share.
+		 *  @details This method sets the task which will be woken each time @c put() 
+		 *           or @c ISR_put() is called. Only one task can subscribe to a given
+		 *           share, but one task can subscribe to many shares. The task must
+		 *           call @c enable_wakeups() for the wakeups to have any effect.
+		 *  @param   p_task Pointer to the task to wake up, or @c NULL for none
+		 */
+		void subscribe (TaskBase* p_task)
+		{
+			p_subscriber = p_task;
 		}
 
 		// This method is used to write data into the shared data item
@@ -130,6 +227,22 @@ template <class DataType> class TaskShare : public BaseShare
 		// This method is used to read data from within an ISR only
 		DataType ISR_get (void);
 
+		// This method reads the data only if it has changed since it was last read
+		bool get_if_changed (DataType& data, share_version_t& last_version);
+
+		// This method waits for a subscribed task until the data has changed
+		bool wait_for_change (share_version_t last_version, TickType_t timeout);
+
+		/** @brief   Return the version number of the data in the share.
+		 *  @details The version number is incremented each time data is written. A
+		 *           task can save it and compare it later to see if there's new data.
+		 *  @return  The current version number of the data
+		 */
+		share_version_t get_version (void)
+		{
+			return (version);
+		}
+
 		// Print the share's status within a list of all shares' statuses (statae?)
 		void print_in_list (emstream* p_ser_dev);
 
@@ -143,6 +256,8 @@ template <class DataType> class TaskShare : public BaseShare
 		{
 			portENTER_CRITICAL ();
 			the_data++;
+			version++;
+			published++;
 			portEXIT_CRITICAL ();
 
 			return (the_data);
@@ -155,6 +270,8 @@ template <class DataType> class TaskShare : public BaseShare
 			DataType result = the_data;
 			portENTER_CRITICAL ();
 			the_data++;
+			version++;
+			published++;
 			portEXIT_CRITICAL ();
 
 			return (result);
@@ -170,6 +287,8 @@ template <class DataType> class TaskShare : public BaseShare
 		{
 			portENTER_CRITICAL ();
 			the_data--;
+			version++;
+			published++;
 			portEXIT_CRITICAL ();
 
 			return (the_data); //// *this);  The BUG
@@ -182,6 +301,8 @@ template <class DataType> class TaskShare : public BaseShare
 			DataType result = the_data;
 			portENTER_CRITICAL ();
 			the_data--;
+			version++;
+			published++;
 			portEXIT_CRITICAL ();
 
 			return (result);
@@ -198,16 +319,36 @@ template <class DataType> class TaskShare : public BaseShare
  *           function. This is faster than doing a regular function call, which
  *           involves pushing the program counter on the stack, pushing parameters, 
  *           jumping, making space for local variables, jumping back and popping the 
- *           program counter, yawn, zzz...
+ *           program counter, yawn, zzz... Types which can be written in one step
+ *           are written without a critical section. The version number is 
+ *           incremented after the data has been written, so a reader which sees the
+ *           new version also sees the new data. For one-byte types the count of
+ *           published updates may miss one if a task and an ISR write at once.
  *  @param   new_data The data which is to be written
  */
 
 template <class DataType>
 inline void TaskShare<DataType>::put (DataType new_data)
 {
-	portENTER_CRITICAL ();
-	the_data = new_data;
-	portEXIT_CRITICAL ();
+	if (share_is_atomic<DataType>::value)
+	{
+		*(volatile DataType*)(&the_data) = new_data;
+		version++;
+		published++;
+	}
+	else
+	{
+		portENTER_CRITICAL ();
+		the_data = new_data;
+		version++;
+		published++;
+		portEXIT_CRITICAL ();
+	}
+
+	if (p_subscriber != NULL)
+	{
+		p_subscriber->wake ();
+	}
 }
 
 
@@ -225,6 +366,13 @@ template <class DataType>
 void TaskShare<DataType>::ISR_put (DataType new_data)
 {
 	the_data = new_data;
+	version++;
+	published++;
+
+	if (p_subscriber != NULL)
+	{
+		p_subscriber->ISR_wake ();
+	}
 }
 
 
@@ -232,13 +380,18 @@ void TaskShare<DataType>::ISR_put (DataType new_data)
 /** @brief   Read data from the shared data item.
  *  @details This method is used to read data from the shared data item with critical
  *           section protection to ensure that the data cannot be corrupted by a task
- *           switch. 
+ *           switch. Types which can be read in one step are read without it.
  *  @return  The current value of the shared data item
  */
 
 template <class DataType>
-DataType TaskShare<DataType>::get (void)
+inline DataType TaskShare<DataType>::get (void)
 {
+	if (share_is_atomic<DataType>::value)
+	{
+		return (*(volatile DataType*)(&the_data));
+	}
+
 	// It's necessary to make an extra, temporary copy of the data so that the
 	// temporary copy can be returned. We can't call return() from within the
 	// critical section for reasons that are obvious if you think about it
@@ -270,6 +423,92 @@ DataType TaskShare<DataType>::ISR_get (void)
 }
 
 
+//-------------------------------------------------------------------------------------
+/** @brief   Read data from the shared data item only if it has changed.
+ *  @details This method compares the version number of the data in the share with
+ *           the version number which the caller saw last time. If they match, nothing
+ *           has been written since then and @c false is returned without copying the
+ *           data. Otherwise the data and its version number are copied together and
+ *           @c true is returned. For one-byte types the version is read before the 
+ *           data, so a write which happens in between only makes the next call 
+ *           return the same data again, which is harmless. This method is for use by
+ *           tasks, not ISR's. 
+ *  @param   data A reference to a variable into which new data will be copied
+ *  @param   last_version A reference to the version number which the caller last 
+ *           saw; it is updated when new data is copied
+ *  @return  @c true if new data was copied, @c false if the data hasn't changed
+ */
+
+template <class DataType>
+bool TaskShare<DataType>::get_if_changed (DataType& data, 
+										  share_version_t& last_version)
+{
+	share_version_t new_version;            // Version of the data which is copied
+
+	if (share_is_atomic<DataType>::value)
+	{
+		new_version = version;
+		if (new_version == last_version)
+		{
+			return (false);
+		}
+		data = *(volatile DataType*)(&the_data);
+	}
+	else
+	{
+		portENTER_CRITICAL ();
+		new_version = version;
+		if (new_version != last_version)
+		{
+			data = the_data;
+		}
+		portEXIT_CRITICAL ();
+
+		if (new_version == last_version)
+		{
+			return (false);
+		}
+	}
+
+	last_version = new_version;
+	consumed++;
+	return (true);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Wait until the data in the share has changed.
+ *  @details This method returns right away if the share's version number differs from
+ *           the one given. If not, it sleeps in the subscribed task's 
+ *           @c wait_for_wakeup() until a write wakes it or the timeout runs out. It 
+ *           must only be called by the subscribed task, and that task must have 
+ *           called @c enable_wakeups(); if no task is subscribed, this method just 
+ *           checks the version number. Because a subscribed task may be woken by 
+ *           other shares as well, a return of @c false doesn't mean the whole timeout
+ *           has passed. Use @c get_if_changed() afterwards to get the new data.
+ *  @param   last_version The version number of the data which the caller last saw
+ *  @param   timeout The longest time to wait, in RTOS ticks
+ *  @return  @c true if the data has changed, @c false if not
+ */
+
+template <class DataType>
+bool TaskShare<DataType>::wait_for_change (share_version_t last_version, 
+										   TickType_t timeout)
+{
+	if (version != last_version)
+	{
+		return (true);
+	}
+
+	if (p_subscriber != NULL)
+	{
+		p_subscriber->wait_for_wakeup (timeout);
+	}
+
+	return (version != last_version);
+}
+
+
 //-------------------------------------------------------------------------------------
 /** @brief   Read data from the shared data item, from within an ISR.
  *  @details This method is used to enable code within an ISR to read data from the 
@@ -293,6 +532,9 @@ void TaskShare<DataType>::print_in_list (emstream* p_ser_dev)
 
 	p_ser_dev->puts ("share\t");
 
+	// Show how many updates have been written and how many have been used
+	*p_ser_dev << published << PMS (" pub, ") << consumed << PMS (" used");
+
 	// End the line
 	*p_ser_dev << endl;
 
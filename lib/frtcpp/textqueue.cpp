@@ -1,11 +1,19 @@
 //*************************************************************************************
 /** \file textqueue.cpp
- *    This file contains a class which interacts with a FreeRTOS character queue to
+ *    This file contains a class which keeps characters in a thread-safe buffer to
  *    make writing things to a character queue very easy. 
  *
  *  Revised:
  *    \li 10-21-2012 JRR Original file
  *    \li 08-26-2014 JRR Changed file names and base task class name to TaskBase
+ *    \li 10-17-2026 AG  Characters kept in a ring buffer; added bulk @c write() and
+ *                       reading of contiguous spans
+ *    \li 10-17-2026 AG  Added @c subscribe() so text arriving can wake a task
+ *    \li 10-17-2026 AG  @c write() overrides @c emstream::write(), so text printed
+ *                       with @c << goes into the queue in blocks
+ *    \li 10-17-2026 AG  Severity levels, each with a policy for a full queue
+ *    \li 10-17-2026 AG  A writer woken for space passes the wakeup on to the next
+ *                       waiting writer if room is left
  *
  *  License:
  *		This file is copyright 2014 by JR Ridgely and released under the Lesser GNU 
@@ -50,14 +58,36 @@ TextQueue::TextQueue (uint16_t queue_size, const char* p_name, emstream* p_ser_d
 	// Save the pointer to the serial device which is used for debugging
 	p_serial = p_ser_dev;
 
-	// Create a FreeRTOS queue object which holds the given number of characters
-	the_queue = xQueueCreate (queue_size, sizeof (char));
+	// Allocate the buffer and the semaphores used to wake up waiting tasks
+	buffer = new char[queue_size];
+	data_sema = xSemaphoreCreateBinary ();
+	space_sema = xSemaphoreCreateBinary ();
+	if (buffer == NULL || data_sema == NULL || space_sema == NULL)
+	{
+		DBG (p_serial, PMS ("ERROR creating ") << queue_size 
+			 << PMS ("B text queue ") << p_name << endl);
+	}
 
 	// Store the wait time; it will be used when writing to the queue
 	ticks_to_wait = a_wait_time;
 
-	// Save the buffer size
+	// Save the buffer size and start out empty
 	buf_size = queue_size;
+	i_put = 0;
+	i_get = 0;
+	how_full = 0;
+	reader_waiting = false;
+	writers_waiting = 0;
+	p_subscriber = NULL;
+	span_out = 0;
+
+	// Text is normally written at the info level, and every level waits for room
+	default_level = TQ_INFO;
+	for (uint8_t level = 0; level < TQ_LEVELS; level++)
+	{
+		policies[level] = TQ_BLOCK;
+		dropped[level] = 0;
+	}
 }
 
 
@@ -72,23 +102,183 @@ TextQueue::TextQueue (uint16_t queue_size, const char* p_name, emstream* p_ser_d
  *  @param   a_char The character to be sent to the queue
  */
 
-inline void TextQueue::putchar (char a_char)
+void TextQueue::putchar (char a_char)
 {
-	xQueueSendToBack (the_queue, &a_char, ticks_to_wait);
+	write (&a_char, 1);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Write a block of characters to the text queue at a severity level.
+ *  @details This method copies characters into the buffer, as many at a time as there
+ *           is room for, in a critical section. The RTOS is only called if the reading
+ *           task is waiting for characters, if the buffer was empty and a task has 
+ *           subscribed to the queue, or if the buffer is full. No more than
+ *           @c TEXT_QUEUE_CHUNK characters are copied in each critical section so that
+ *           interrupts aren't held off for long. 
+ * 
+ *           What happens when the buffer is full depends on the level's policy. With
+ *           @c TQ_BLOCK, this method waits for space just as @c putchar() does, and 
+ *           if the wait times out the rest of the characters are dropped. With 
+ *           @c TQ_DROP_NEWEST the rest are dropped at once. With @c TQ_DROP_OLDEST 
+ *           the oldest characters in the buffer are thrown away to make room; but 
+ *           characters which the reader has been given by @c get_span() can't be 
+ *           thrown away, so while it holds them, new characters are dropped instead.
+ *           Every dropped character is counted against the level being written. 
+ *  @param   p_data Pointer to the characters to be written
+ *  @param   count The number of characters to write
+ *  @param   level The severity level of the text, such as @c TQ_DEBUG
+ *  @return  The number of characters which were written
+ */
+
+uint16_t TextQueue::write (const char* p_data, uint16_t count, uint8_t level)
+{
+	uint16_t done = 0;                      // Number of characters written so far
+	uint16_t chunk;                         // Number written in one critical section
+	uint16_t room;                          // Number of empty spaces in the buffer
+	bool wake_reader;                       // True if the reader needs to be woken
+	bool was_empty;                         // True if there was nothing to read
+	bool must_wait;                         // True if the buffer is full
+	bool give_up;                           // True if the rest are to be dropped
+
+	if (level >= TQ_LEVELS)
+	{
+		level = TQ_LEVELS - 1;
+	}
+	uint8_t policy = policies[level];
+
+	while (done < count)
+	{
+		portENTER_CRITICAL ();
+		was_empty = (how_full == 0);
+		chunk = count - done;
+		if (chunk > TEXT_QUEUE_CHUNK)
+		{
+			chunk = TEXT_QUEUE_CHUNK;
+		}
+		if (chunk > buf_size)
+		{
+			chunk = buf_size;
+		}
+
+		// Under the drop oldest policy, make room by throwing away the oldest 
+		// characters, as long as the reader isn't holding a span of them
+		room = buf_size - how_full;
+		if (policy == TQ_DROP_OLDEST && room < chunk && span_out == 0)
+		{
+			uint16_t discard = chunk - room;
+
+			i_get += discard;
+			if (i_get >= buf_size)
+			{
+				i_get -= buf_size;
+			}
+			how_full -= discard;
+			dropped[level] += discard;
+			room = chunk;
+		}
+		if (chunk > room)
+		{
+			chunk = room;
+		}
+		for (uint16_t index = chunk; index > 0; index--)
+		{
+			buffer[i_put] = *p_data++;
+			if (++i_put >= buf_size)
+			{
+				i_put = 0;
+			}
+		}
+		how_full += chunk;
+		done += chunk;
+
+		wake_reader = reader_waiting && chunk != 0;
+		if (wake_reader)
+		{
+			reader_waiting = false;
+		}
+
+		// If the buffer is full, wait or drop the rest as the level's policy says; 
+		// under drop oldest, go around again to throw away more old characters
+		must_wait = false;
+		give_up = false;
+		if (how_full >= buf_size && done < count)
+		{
+			if (policy == TQ_BLOCK)
+			{
+				must_wait = true;
+				writers_waiting++;
+			}
+			else if (policy == TQ_DROP_NEWEST || span_out != 0)
+			{
+				dropped[level] += count - done;
+				give_up = true;
+			}
+		}
+		portEXIT_CRITICAL ();
+
+		if (wake_reader)
+		{
+			xSemaphoreGive (data_sema);
+		}
+		if (was_empty && chunk != 0 && p_subscriber != NULL)
+		{
+			p_subscriber->wake ();
+		}
+
+		if (give_up)
+		{
+			break;
+		}
+
+		// If the buffer is full, wait for the reader to make room. The semaphore only
+		// wakes one writer at a time, so if others are waiting and there's still room,
+		// the wakeup is passed on to the next one
+		if (must_wait)
+		{
+			bool got_space = xSemaphoreTake (space_sema, ticks_to_wait);
+			bool wake_next;
+
+			portENTER_CRITICAL ();
+			writers_waiting--;
+			if (!got_space)
+			{
+				dropped[level] += count - done;
+			}
+			wake_next = (got_space && writers_waiting != 0 && how_full < buf_size);
+			portEXIT_CRITICAL ();
+
+			if (wake_next)
+			{
+				xSemaphoreGive (space_sema);
+			}
+			if (!got_space)
+			{
+				break;
+			}
+		}
+	}
+
+	return (done);
 }
 
 
 //-------------------------------------------------------------------------------------
 /** @brief   Check if a character is ready to be read from the queue.
- *  @details This method checks if there is a character in the queue. It just calls 
- *           the FreeRTOS function @c uxQueueMessagesWaiting(); if there's anything in
- *           the queue, the return value from that function will be greater than zero. 
+ *  @details This method checks if there is a character in the queue. The count of 
+ *           characters is two bytes long, so it's read in a critical section.
  *  @return  True for character available, false for no character available
  */
 
-inline bool TextQueue::check_for_char (void)
+bool TextQueue::check_for_char (void)
 {
-	return (uxQueueMessagesWaiting (the_queue));
+	bool not_empty;                         // True if there's anything in the buffer
+
+	portENTER_CRITICAL ();
+	not_empty = (how_full != 0);
+	portEXIT_CRITICAL ();
+
+	return (not_empty);
 }
 
 
@@ -101,21 +291,117 @@ inline bool TextQueue::check_for_char (void)
  *  @return  The character which was received from the queue
  */
 
-inline char TextQueue::getchar (void)
+char TextQueue::getchar (void)
 {
-	char recv_char;							// Character read from the queue
+	const char* p_char;                     // Points to the character to be read
+	bool must_wait;                         // True if the queue is still empty
 
-	// If xQueueReceive doesn't return pdTrue, nothing was found in the queue
-	if (xQueueReceive (the_queue, &recv_char, portMAX_DELAY) != pdTRUE)
+	// If the queue is empty, say that this task is waiting so the next write will
+	// give the semaphore, then wait for it
+	while (get_span (p_char) == 0)
 	{
-		return (-1);
+		portENTER_CRITICAL ();
+		must_wait = (how_full == 0);
+		reader_waiting = must_wait;
+		portEXIT_CRITICAL ();
+
+		if (must_wait)
+		{
+			xSemaphoreTake (data_sema, portMAX_DELAY);
+		}
 	}
 
-	// OK, we got good data from the queue, so return it
+	char recv_char = *p_char;
+	consume (1);
+
 	return (recv_char);
 }
 
 
+//-------------------------------------------------------------------------------------
+/** @brief   Find the characters which can be read from one contiguous part of memory.
+ *  @details This method finds the oldest characters in the queue which are next to 
+ *           each other in the buffer; the characters which have wrapped around to the
+ *           beginning of the buffer will be found by the next call. The characters 
+ *           aren't removed, and writers won't overwrite them, until @c consume() is 
+ *           called. This method never blocks. Only one task may read. 
+ *  @param   p_start A reference to a pointer which is set to the first character
+ *  @return  The number of characters which can be read starting at @c p_start
+ */
+
+uint16_t TextQueue::get_span (const char*& p_start)
+{
+	uint16_t length;                        // Number of contiguous characters
+
+	portENTER_CRITICAL ();
+	p_start = buffer + i_get;
+	length = buf_size - i_get;
+	if (length > how_full)
+	{
+		length = how_full;
+	}
+	span_out = length;
+	portEXIT_CRITICAL ();
+
+	return (length);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Remove characters which have been read from the queue.
+ *  @details This method removes the given number of the oldest characters from the 
+ *           queue, making room for more. A task which is waiting for space is woken;
+ *           it wakes the next waiting writer, if any, when there's room left over.
+ *  @param   count The number of characters to remove, which must not be more than 
+ *                 was returned by @c get_span()
+ */
+
+void TextQueue::consume (uint16_t count)
+{
+	bool wake_writer;                       // True if a writer needs to be woken
+
+	portENTER_CRITICAL ();
+	i_get += count;
+	if (i_get >= buf_size)
+	{
+		i_get -= buf_size;
+	}
+	how_full -= count;
+	span_out = 0;
+	wake_writer = (writers_waiting != 0 && count != 0);
+	portEXIT_CRITICAL ();
+
+	if (wake_writer)
+	{
+		xSemaphoreGive (space_sema);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Get the number of characters of a given level which have been dropped.
+ *  @details The count is two bytes long and is changed by writing tasks, so it's 
+ *           read in a critical section.
+ *  @param   level The severity level, such as @c TQ_DEBUG
+ *  @return  The number of characters of that level dropped since the queue was made
+ */
+
+uint16_t TextQueue::get_dropped (uint8_t level)
+{
+	uint16_t count;                         // Copy of the count of dropped characters
+
+	if (level >= TQ_LEVELS)
+	{
+		return (0);
+	}
+	portENTER_CRITICAL ();
+	count = dropped[level];
+	portEXIT_CRITICAL ();
+
+	return (count);
+}
+
+
 //-------------------------------------------------------------------------------------
 /** @brief   Print the status of the queue.
  *  @details This method writes the status of the text queue to the given serial 
@@ -136,7 +422,18 @@ void TextQueue::print_in_list (emstream* p_ser_dev)
 	p_ser_dev->puts ("txt_q\t");
 
 	// Print the free and total number of spaces in the queue
-	*p_ser_dev << uxQueueSpacesAvailable (the_queue) << '/' << buf_size << '\t';
+	*p_ser_dev << (uint16_t)(buf_size - how_full) << '/' << buf_size << '\t';
+
+	// Print the number of characters dropped at each level, least severe first
+	*p_ser_dev << PMS ("dropped ");
+	for (uint8_t level = 0; level < TQ_LEVELS; level++)
+	{
+		if (level != 0)
+		{
+			p_ser_dev->putchar ('/');
+		}
+		*p_ser_dev << get_dropped (level);
+	}
 
 	// End the line
 	*p_ser_dev << endl;
@@ -6,6 +6,12 @@
  *  Revised:
  *    \li 10-21-2012 JRR Original file
  *    \li 08-26-2014 JRR Changed file names and base task class name to TaskBase
+ *    \li 10-17-2026 AG  Characters kept in a ring buffer; added bulk @c write() and
+ *                       reading of contiguous spans
+ *    \li 10-17-2026 AG  Added @c subscribe() so text arriving can wake a task
+ *    \li 10-17-2026 AG  @c write() overrides @c emstream::write(), so text printed
+ *                       with @c << goes into the queue in blocks
+ *    \li 10-17-2026 AG  Severity levels, each with a policy for a full queue
  *
  *  License:
  *		This file is copyright 2014 by JR Ridgely and released under the Lesser GNU 
@@ -28,14 +34,46 @@
 #define _TEXT_QUEUE_H_
 
 #include "FreeRTOS.h"                       // Main header for FreeRTOS
-#include "queue.h"                          // Header for FreeRTOS queues
+#include "semphr.h"                         // Header for FreeRTOS semaphores
 #include "emstream.h"                       // Pull in the base class header file
 #include "baseshare.h"                      // Base class for thread-safe shared data
+#include "taskbase.h"                       // Tasks which can be woken by the queue
+
+
+/** This is the largest number of characters which @c TextQueue::write() copies into
+ *  the buffer in one critical section. Longer blocks are copied in pieces so that 
+ *  interrupts are never held off for more than a few microseconds.
+ */
+const uint8_t TEXT_QUEUE_CHUNK = 16;
+
+
+/** @brief   Severity levels for text written to a @c TextQueue.
+ *  @details Each level has its own policy for what to do when the queue is full and
+ *           its own count of characters dropped. 
+ */
+enum text_level
+{
+	TQ_DEBUG,                               ///< Debugging chatter
+	TQ_INFO,                                ///< Normal messages
+	TQ_WARNING,                             ///< Something unusual happened
+	TQ_ERROR,                               ///< Something went wrong
+	TQ_LEVELS                               ///< The number of levels
+};
+
+
+/** @brief   Policies for text written to a @c TextQueue which is full.
+ */
+enum text_policy
+{
+	TQ_BLOCK,                               ///< Wait for room, up to the timeout
+	TQ_DROP_NEWEST,                         ///< Throw away text which doesn't fit
+	TQ_DROP_OLDEST                          ///< Throw away the oldest text for room
+};
 
 
 //-------------------------------------------------------------------------------------
-/** @brief   Converts data to characters with @c << and puts them into a FreeRTOS 
- *           queue. 
+/** @brief   Converts data to characters with @c << and puts them into a thread-safe 
+ *           buffer. 
  *  @details This class uses the @c emstream operator @c << to print variables as text
  *           strings, then puts the text into a queue.  The queue conveys the 
  *           characters to another task which does something useful with those 
@@ -44,6 +82,21 @@
  *           queue uses the overloaded shift operator @c << in the same style as the 
  *           C++ standard library's @c iostream objects such as @c cout. 
  * 
+ *           The characters are kept in a ring buffer in the style of a stream buffer 
+ *           rather than in a FreeRTOS queue. A write copies characters in a short 
+ *           critical section and only calls the RTOS when a task has to be woken up,
+ *           so a block of text given to @c write() costs about as much as one 
+ *           character used to. The task which empties the queue can take a whole 
+ *           contiguous span of characters at a time with @c get_span() and 
+ *           @c consume(). Any number of tasks may write, but only one may read. 
+ * 
+ *           Text is written at one of four severity levels, from @c TQ_DEBUG to 
+ *           @c TQ_ERROR, and each level has a policy for a full queue: wait for 
+ *           room, drop the new text, or drop the oldest text in the queue. This 
+ *           lets important messages wait for room while chatter from tasks which 
+ *           mustn't be held up is thrown away. The characters dropped at each level 
+ *           are counted and shown by @c print_all_shares(). 
+ * 
  *  \section Usage
  *  In the file which contains @c main() we create a pointer to a @c TextQueue 
  *  object and use the @c new operator to create the queue itself. (This can be done
@@ -84,6 +137,21 @@
  *      my_card->putchar (p_text_queue->getchar ());
  *  }
  *  \endcode
+ *  Or, to move all the characters which are next to each other in the buffer at once:
+ *  @code
+ *  const char* p_text;
+ *  uint16_t length = p_text_queue->get_span (p_text);
+ *  for (uint16_t count = 0; count < length; count++)
+ *  {
+ *      my_card->putchar (p_text[count]);
+ *  }
+ *  p_text_queue->consume (length);
+ *  \endcode
+ *  A task which reads from several places, such as a user interface task which reads
+ *  both the print queue and a serial port, can't block in @c getchar(). Instead it 
+ *  calls @c enable_wakeups(), is subscribed to the queue with 
+ *  @c p_text_queue->subscribe(p_task), and sleeps in @c wait_for_wakeup() once it 
+ *  has emptied the queue; the next character written to the empty queue wakes it. 
  *  The reason that the data was not directly written to the SD card in the sending
  *  task is timing: in this example, we assume that the sending task takes data at
  *  regular intervals. Writing data to an SD card, however, takes varying amounts of
@@ -96,44 +164,186 @@ class TextQueue : public emstream, public BaseShare
 {
 	// This protected data can only be accessed from this class or its descendents
 	protected:
-		QueueHandle_t the_queue;            ///< The handle for the queue we use
+		char* buffer;                       ///< Memory which holds the characters
+		uint16_t buf_size;                  ///< Size of queue buffer in bytes
+		uint16_t i_put;                     ///< Index where the next character goes
+		uint16_t i_get;                     ///< Index of the oldest character
+		uint16_t how_full;                  ///< Number of characters in the buffer
 		TickType_t ticks_to_wait;           ///< RTOS ticks to wait for empty queue
 		emstream* p_serial;                 ///< Serial device used for debugging
-		uint16_t buf_size;                  ///< Size of queue buffer in bytes
+
+		/// This semaphore is given to wake the reading task when characters arrive.
+		SemaphoreHandle_t data_sema;
+
+		/// This semaphore is given to wake a writing task when space is freed.
+		SemaphoreHandle_t space_sema;
+
+		/// This is @c true when the reading task is waiting for characters.
+		bool reader_waiting;
+
+		/// This is the number of writing tasks waiting for space in the buffer.
+		uint8_t writers_waiting;
+
+		/// This task, if not @c NULL, is woken when text is put into an empty queue.
+		TaskBase* p_subscriber;
+
+		/// The number of characters handed to the reader by @c get_span() but not 
+		/// yet consumed; they mustn't be thrown away by the drop oldest policy.
+		uint16_t span_out;
+
+		/// The level at which text written with @c << or @c write() is written.
+		uint8_t default_level;
+
+		/// What each level of text does when the queue is full.
+		uint8_t policies[TQ_LEVELS];
+
+		/// The number of characters of each level which have been thrown away.
+		uint16_t dropped[TQ_LEVELS];
 
 	// Public methods can be called from anywhere in the program where there is a 
 	// pointer or reference to an object of this class
 	public:
-		// The constructor creates a FreeRTOS queue with a fancy wrapper
+		// The constructor creates a character buffer with a fancy wrapper
 		TextQueue (uint16_t size, const char* p_name, emstream* = NULL, 
 				   TickType_t = portMAX_DELAY);
 
 		void putchar (char);                // Write one character to the queue
+
+		/** @brief   Write a block of characters to the queue at the default level.
+		 *  @details This method overrides @c emstream::write(), so strings and 
+		 *           numbers printed into the queue with @c << arrive here in blocks.
+		 *  @param   p_data Pointer to the characters to be written
+		 *  @param   count The number of characters to write
+		 *  @return  The number of characters which were written
+		 */
+		uint16_t write (const char* p_data, uint16_t count)
+		{
+			return (write (p_data, count, default_level));
+		}
+
+		// Write a block of characters to the queue at the given severity level
+		uint16_t write (const char* p_data, uint16_t count, uint8_t level);
+
+		/** @brief   Set what text of a given severity level does if the queue is full.
+		 *  @details Text of a level whose policy is @c TQ_BLOCK waits for room, for up
+		 *           to the number of ticks given to the constructor. With 
+		 *           @c TQ_DROP_NEWEST, text which doesn't fit is thrown away, and with
+		 *           @c TQ_DROP_OLDEST, the oldest text in the queue is thrown away to
+		 *           make room. Tasks which mustn't be held up should write at levels
+		 *           which never block. All levels block unless told otherwise.
+		 *  @param   level The severity level, such as @c TQ_DEBUG
+		 *  @param   policy The policy, such as @c TQ_DROP_NEWEST
+		 */
+		void set_policy (uint8_t level, uint8_t policy)
+		{
+			if (level < TQ_LEVELS)
+			{
+				policies[level] = policy;
+			}
+		}
+
+		/** @brief   Set the level of text written with @c << or @c write().
+		 *  @details This level is shared by every task which writes to the queue 
+		 *           directly. Tasks which need their own level should write through a
+		 *           @c TextQueueWriter. 
+		 *  @param   level The severity level, such as @c TQ_INFO
+		 */
+		void set_level (uint8_t level)
+		{
+			if (level < TQ_LEVELS)
+			{
+				default_level = level;
+			}
+		}
+
+		// Get the number of characters of a given level which have been dropped
+		uint16_t get_dropped (uint8_t level);
+
 		bool check_for_char (void);         // Check if a character is in the queue
+
 		char getchar (void);                // Read a character from the queue
 
+		// Find the characters which can be read from one contiguous part of memory
+		uint16_t get_span (const char*& p_start);
+
+		// Remove characters which have been read with get_span() from the queue
+		void consume (uint16_t count);
+
 		/** This overloaded boolean operator allows one to check if the queue has any
 		 *  contents which can be read by just checking if the queue is true. It might
 		 *  not be the most intuitive method to use, but it sure is convenient. 
 		 */
-		operator bool () const
+		operator bool ()
 		{
-			return (uxQueueMessagesWaiting (the_queue) != 0);
+			return (check_for_char ());
 		}
 
-		/** If somebody wants to do something which FreeRTOS queues can do but this
-		 *  class doesn't support, a handle for the queue inside this class can be
-		 *  used to access the queue directly. This isn't normally done.
-		 *  @return A handle to the FreeRTOS queue structure which is wrapped up by
-		 *          this handy C++ class
+		/** @brief   Have the given task woken up when text is put into the queue.
+		 *  @details The task is woken when characters are written into an empty 
+		 *           queue; it should read everything in the queue before it waits 
+		 *           again. The task must have called @c enable_wakeups().
+		 *  @param   p_task Pointer to the task to wake up, or @c NULL for none
 		 */
-		QueueHandle_t get_handle (void)
+		void subscribe (TaskBase* p_task)
 		{
-			return (the_queue);
+			p_subscriber = p_task;
 		}
 
 		// Print the status of this queue in the table of queue status printouts
 		void print_in_list (emstream* p_ser_dev);
 };
 
+
+//-------------------------------------------------------------------------------------
+/** @brief   Writes text into a @c TextQueue at one severity level.
+ *  @details A task which writes text of a particular level, for example debugging 
+ *           messages from a control task, prints to one of these instead of to the
+ *           queue itself. Everything printed through it with @c << is written to 
+ *           the queue at the writer's level, so it's handled by that level's policy.
+ *           A writer holds no text of its own, but like any @c emstream it keeps 
+ *           settings such as the number base, so each task should have its own.
+ *  @code
+ *  TextQueueWriter* p_debug = new TextQueueWriter (p_print_ser_queue, TQ_DEBUG);
+ *  ...
+ *  *p_debug << PMS ("Speed: ") << speed << endl;
+ *  @endcode
+ */
+
+class TextQueueWriter : public emstream
+{
+	protected:
+		TextQueue* p_queue;                 ///< The queue into which text is written
+		uint8_t level;                      ///< The severity level of the text
+
+	public:
+		/** @brief   Create a writer for text of the given level.
+		 *  @param   p_text_queue Pointer to the queue into which text is written
+		 *  @param   a_level The severity level, such as @c TQ_DEBUG
+		 */
+		TextQueueWriter (TextQueue* p_text_queue, uint8_t a_level)
+			: emstream ()
+		{
+			p_queue = p_text_queue;
+			level = a_level;
+		}
+
+		/** @brief   Write one character into the queue at this writer's level.
+		 *  @param   a_char The character to be written
+		 */
+		void putchar (char a_char)
+		{
+			p_queue->write (&a_char, 1, level);
+		}
+
+		/** @brief   Write a block of characters into the queue at this writer's level.
+		 *  @param   p_data Pointer to the characters to be written
+		 *  @param   count The number of characters to write
+		 *  @return  The number of characters which were written
+		 */
+		uint16_t write (const char* p_data, uint16_t count)
+		{
+			return (p_queue->write (p_data, count, level));
+		}
+};
+
 #endif  // _TEXT_QUEUE_H_
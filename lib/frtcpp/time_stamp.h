@@ -21,6 +21,10 @@
  *    \li 10-10-2012 JRR Made time_stamp::set_to_now() return a reference to the stamp
  *    \li 12-02-2012 JRR Split many methods and operators into their own \c .cpp files
  *                       in order to save memory in the compiled machine code
+ *    \li 10-17-2026 AG  Added constants for the FreeRTOS run time statistics counter
+ *    \li 10-17-2026 AG  Added now_us(), a 64-bit microsecond clock, and conversions
+ *    \li 10-17-2026 AG  Made arithmetic, comparisons and conversions inline methods so
+ *                       the compiler can fold them into the code which uses them
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -66,6 +70,49 @@ const uint32_t HW_TICK_RATE_HZ = configCPU_CLOCK_HZ / portCLOCK_PRESCALER;
 const uint32_t TMR_MAX_CT = configCPU_CLOCK_HZ / 
 						   (configTICK_RATE_HZ * portCLOCK_PRESCALER);
 
+/** This is the number of bits by which the hardware timer count is shifted right to 
+ *  make the FreeRTOS run time statistics counter. With a 2 MHz hardware count, a 
+ *  shift of 3 gives a 4 microsecond resolution, and the 32-bit counter takes almost
+ *  five hours to overflow.
+ */
+#define RUN_TIME_SHIFT		3
+
+/// This constant holds the number of run time counter ticks per second.
+const uint32_t RUN_TIME_RATE_HZ = HW_TICK_RATE_HZ >> RUN_TIME_SHIFT;
+
+/// This constant holds the number of run time counter ticks per RTOS tick.
+const uint32_t RUN_TIME_PER_TICK = TMR_MAX_CT >> RUN_TIME_SHIFT;
+
+/** This constant holds the number of microseconds in each RTOS tick. The RTOS tick 
+ *  rate must divide evenly into a million so that no time is lost at each tick.
+ */
+const uint32_t US_PER_TICK = 1000000UL / configTICK_RATE_HZ;
+
+/** This is the number of bits by which a hardware timer count, multiplied by 
+ *  @c HW_US_MULT, is shifted right to give microseconds.
+ */
+#define HW_US_SHIFT			16
+
+/** This constant converts hardware timer counts into microseconds with a multiply 
+ *  and a shift, so no division is needed. With a 2 MHz hardware count it's a power
+ *  of two, and the compiler turns the whole conversion into a shift.
+ */
+const uint32_t HW_US_MULT = (uint32_t)((1000000ULL << HW_US_SHIFT) / HW_TICK_RATE_HZ);
+
+
+//--------------------------------------------------------------------------------------
+/** This function converts a count of the hardware timer into microseconds. The count
+ *  may be as large as two RTOS ticks' worth, as happens when a compare match has been
+ *  seen but the tick interrupt hasn't run yet. 
+ *  @param hw_ticks A number of hardware timer counts
+ *  @return The number of whole microseconds in that many hardware timer counts
+ */
+
+inline uint16_t hw_count_to_us (HW_CTR_TYPE hw_ticks)
+{
+	return ((uint16_t)(((uint32_t)hw_ticks * HW_US_MULT) >> HW_US_SHIFT));
+}
+
 
 //--------------------------------------------------------------------------------------
 /** \brief This class holds a time stamp which is used to measure the passage of real 
@@ -124,11 +171,45 @@ class time_stamp
 			return (tick_count / configTICK_RATE_HZ);
 		}
 
-		// This method returns the number of microseconds in the time stamp
-		uint32_t get_microsec (void);
+		/** This method returns the number of microseconds in the time stamp, after
+		 *  the seconds are subtracted out. The leftover RTOS ticks are multiplied by
+		 *  the number of microseconds per tick and the hardware count is converted 
+		 *  with a multiply and shift, so the only division is the one which takes 
+		 *  out the seconds. 
+		 *  @return The number of microseconds in time stamp
+		 */
+		uint32_t get_microsec (void) const
+		{
+			return ((tick_count % configTICK_RATE_HZ) * US_PER_TICK
+					+ hw_count_to_us (hardware_count));
+		}
 
-		// This method returns the time in the time stamp as a float
-		float to_float (void);
+		/** This method returns the time in the time stamp as a floating point number
+		 *  of seconds. The counts are multiplied by constant reciprocals, which the 
+		 *  compiler works out ahead of time, rather than divided. Floats are slow on
+		 *  an AVR; to print a time stamp, use @c << rather than this method.
+		 *  @return The time in the time stamp in seconds
+		 */
+		float to_float (void) const
+		{
+			return ((float)tick_count * (1.0f / configTICK_RATE_HZ)
+					+ (float)hardware_count * (1.0f / HW_TICK_RATE_HZ));
+		}
+
+		/** This method returns the time in the time stamp as a number of 
+		 *  microseconds, found without any division. Because the RTOS tick count 
+		 *  wraps after about 49 days, so does the result; times which must go on 
+		 *  longer than that should be kept with @c now_us().
+		 *  @return The time in the time stamp in microseconds
+		 */
+		uint64_t to_us (void) const
+		{
+			return ((uint64_t)tick_count * US_PER_TICK 
+					+ hw_count_to_us (hardware_count));
+		}
+
+		// This method sets the time stamp from a number of microseconds
+		time_stamp& set_from_us (uint64_t);
 
 		// This function gets the time from the RTOS scheduler into this time stamp
 		time_stamp& set_to_now (void);
@@ -137,42 +218,213 @@ class time_stamp
 		// in a way that can be used within an Interrupt Service Routine
 		void set_to_now_in_ISR (void);
 
-		// This overloaded addition operator adds two time stamps together
-		time_stamp operator + (const time_stamp&);
+		/** This overloaded addition operator adds another time stamp's time to this 
+		 *  one. It can be used to find the time in the future at which some event is
+		 *  to be caused to happen, such as the next time a task is supposed to run. 
+		 *  @param addend The other time stamp which is to be added to this one
+		 *  @return The newly created time stamp
+		 */
+		time_stamp operator + (const time_stamp& addend) const
+		{
+			time_stamp ret_stamp (*this);
 
-		// This overloaded subtraction operator finds the time between two time stamps
-		time_stamp operator - (const time_stamp&);
+			ret_stamp += addend;
+			return (ret_stamp);
+		}
 
-		// This overloaded addition operator adds two time stamps together
-		void operator += (const time_stamp&);
+		/** This overloaded subtraction operator finds the duration between this time 
+		 *  stamp's recorded time and a previous one. Since the data used is unsigned,
+		 *  the results will be messed up if a later time stamp is subtracted from an
+		 *  earlier one. Please don't.
+		 *  @param previous An earlier time stamp to be compared to the current one 
+		 *  @return The newly created time stamp
+		 */
+		time_stamp operator - (const time_stamp& previous) const
+		{
+			time_stamp ret_stamp (*this);
 
-		// This overloaded subtraction operator finds the time between two time stamps
-		void operator -= (const time_stamp&);
+			ret_stamp -= previous;
+			return (ret_stamp);
+		}
 
-		// This overloaded equality operator tests if two time stamps are the same
-		bool operator == (const time_stamp&);
+		/** This overloaded addition operator adds another time stamp's time to this
+		 *  one. If the hardware counts add up to a whole RTOS tick or more, the 
+		 *  overflow is carried into the RTOS tick count.
+		 *  @param addend The other time stamp which is to be added to this one
+		 */
+		void operator += (const time_stamp& addend)
+		{
+			hardware_count += addend.hardware_count;
+			tick_count += addend.tick_count;
+			if (hardware_count >= TMR_MAX_CT)
+			{
+				hardware_count -= TMR_MAX_CT;
+				tick_count++;
+			}
+		}
 
-		// This overloaded equality operator tests if two time stamps are not the same
-		bool operator != (const time_stamp&);
+		/** This overloaded subtraction operator finds the duration between this time
+		 *  stamp's recorded time and a previous one. The data in this timestamp is 
+		 *  replaced with the computed duration. If the (unsigned) hardware count 
+		 *  seems to be greater than the maximum possible hardware count, it's 
+		 *  actually a negative number, so one is borrowed from the tick count.
+		 *  @param previous An earlier time stamp to be compared to the current one 
+		 */
+		void operator -= (const time_stamp& previous)
+		{
+			tick_count -= previous.tick_count;
+			hardware_count -= previous.hardware_count;
+			if (hardware_count >= TMR_MAX_CT)
+			{
+				tick_count--;
+				hardware_count += TMR_MAX_CT;
+			}
+		}
 
-		// This operator tests if a time stamp is greater (later) or equal to this one
-		bool operator >= (const time_stamp&);
+		/** This overloaded equality operator checks if the time in some other time 
+		 *  stamp is exactly equal to that in this one, down to the resolution of the
+		 *  hardware timer. Usually an inequality test is more useful.
+		 *  @param other A time stamp to be compared to this one 
+		 *  @return True if the time stamps contain equal data, false if they don't
+		 */
+		bool operator == (const time_stamp& other) const
+		{
+			return ((hardware_count == other.hardware_count)
+					&& (tick_count == other.tick_count));
+		}
 
-		// This overloaded operator tests if a time stamp is greater (later) than this
-		bool operator > (const time_stamp&);
+		/** This overloaded inequality operator checks if some other time stamp is
+		 *  not equal to this one. 
+		 *  @param other A time stamp to be compared to this one 
+		 *  @return True if the time stamps contain different data
+		 */
+		bool operator != (const time_stamp& other) const
+		{
+			return (!(*this == other));
+		}
 
-		// This operator tests if a time stamp is less (earlier) than this one
-		bool operator <= (const time_stamp&);
+		/** This operator tests if this time stamp is greater than (later than) 
+		 *  another one. The RTOS tick counts are compared first; only if they're the
+		 *  same are the hardware counts compared. 
+		 *  @param other A time stamp to be compared to this one 
+		 *  @return True if this time stamp is greater than the other one
+		 */
+		bool operator > (const time_stamp& other) const
+		{
+			if (tick_count != other.tick_count)
+			{
+				return (tick_count > other.tick_count);
+			}
+			return (hardware_count > other.hardware_count);
+		}
 
-		// This operator tests if a time stamp is less (earlier) or equal to this one
-		bool operator < (const time_stamp&);
+		/** This operator tests if this time stamp is less than (earlier than) 
+		 *  another one.
+		 *  @param other A time stamp to be compared to this one 
+		 *  @return True if this time stamp is less than the other one
+		 */
+		bool operator < (const time_stamp& other) const
+		{
+			return (other > *this);
+		}
+
+		/** This operator tests if this time stamp is greater than or equal to 
+		 *  another one.
+		 *  @param other A time stamp to be compared to this one 
+		 *  @return True if this time stamp is greater than or equal to the other one
+		 */
+		bool operator >= (const time_stamp& other) const
+		{
+			return (!(other > *this));
+		}
+
+		/** This operator tests if this time stamp is less than or equal to another 
+		 *  one.
+		 *  @param other A time stamp to be compared to this one 
+		 *  @return True if this time stamp is less than or equal to the other one
+		 */
+		bool operator <= (const time_stamp& other) const
+		{
+			return (!(*this > other));
+		}
 };
 
 
+//--------------------------------------------------------------------------------------
+/** This function converts a number of milliseconds into RTOS ticks. It's meant to be 
+ *  used with constants, which the compiler converts while compiling, for example in
+ *  @c vTaskDelay(ms_to_ticks(5)). 
+ *  @param ms A number of milliseconds
+ *  @return The number of whole RTOS ticks in that many milliseconds
+ */
+
+inline TickType_t ms_to_ticks (uint32_t ms)
+{
+	if (configTICK_RATE_HZ % 1000UL == 0)
+	{
+		return ((TickType_t)(ms * (configTICK_RATE_HZ / 1000UL)));
+	}
+	return ((TickType_t)(ms * configTICK_RATE_HZ / 1000UL));
+}
+
+
+//--------------------------------------------------------------------------------------
+/** This function converts a number of microseconds into whole RTOS ticks. Like
+ *  @c ms_to_ticks(), it's meant to be used with constants. 
+ *  @param us A number of microseconds
+ *  @return The number of whole RTOS ticks in that many microseconds
+ */
+
+inline TickType_t us_to_ticks (uint32_t us)
+{
+	return ((TickType_t)(us / US_PER_TICK));
+}
+
+
+//--------------------------------------------------------------------------------------
+/** This function converts a number of microseconds into counts of the hardware timer
+ *  which runs the RTOS tick. Like @c ms_to_ticks(), it's meant to be used with 
+ *  constants. The hardware timer must count at a whole number of megahertz, as it 
+ *  does at 2 MHz. 
+ *  @param us A number of microseconds
+ *  @return The number of hardware timer counts in that many microseconds
+ */
+
+inline uint32_t us_to_hw_count (uint32_t us)
+{
+	return (us * (HW_TICK_RATE_HZ / 1000000UL));
+}
+
+
+//--------------------------------------------------------------------------------------
+/** This function makes a time stamp which holds a given number of microseconds. It
+ *  is useful for making timeouts and periods which are compared with the difference
+ *  between two time stamps; given a constant, the compiler works out the time stamp's
+ *  contents while compiling, for example:
+ *  @code
+ *  const time_stamp timeout = us_to_time_stamp (2500);
+ *  ...
+ *  if (now.set_to_now () - start >= timeout) ...
+ *  @endcode
+ *  @param us A number of microseconds
+ *  @return A time stamp holding that many microseconds
+ */
+
+inline time_stamp us_to_time_stamp (uint32_t us)
+{
+	return (time_stamp (us_to_ticks (us), 
+						(HW_CTR_TYPE)us_to_hw_count (us % US_PER_TICK)));
+}
+
+
 //--------------------------------------------------------------------------------------
 // This operator allows a time stamp to be written to serial device 'cout' style
 emstream& operator<< (emstream&, time_stamp&);
 
+//--------------------------------------------------------------------------------------
+// This function reads the 64-bit microsecond clock; it may be called from an ISR
+uint64_t now_us (void);
+
 //--------------------------------------------------------------------------------------
 // This function computes time quickly using only RTOS timer ticks and makes a string
 const char* tick_res_time (void);
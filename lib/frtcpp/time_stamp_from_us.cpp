@@ -0,0 +1,66 @@
+//**************************************************************************************
+/** \file time_stamp_from_us.cpp
+ *    This file contains a method belonging to class \c time_stamp which sets the time
+ *    stamp from a 64-bit number of microseconds, such as one read from \c now_us().
+ *
+ *  Revisions:
+ *    \li 10-17-2026 AG  Original file
+ *    \li 10-17-2026 AG  Noted why the 64-bit division isn't a shift
+ *
+ *  License:
+ *    This file is copyright 2026 by agent (AG) and released under the Lesser GNU 
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include "FreeRTOS.h"                       // Main header for FreeRTOS 
+#include "time_stamp.h"                     // Header for this file
+
+
+/** This constant converts microseconds into hardware timer counts with a multiply and
+ *  a shift by @c HW_US_SHIFT bits. 
+ */
+const uint32_t US_HW_MULT = (uint32_t)(((uint64_t)HW_TICK_RATE_HZ << HW_US_SHIFT) 
+									   / 1000000UL);
+
+/** The whole RTOS ticks are found by a 64-bit division because @c US_PER_TICK, 1000
+ *  at the usual 1 kHz tick rate, isn't a power of two; of the tick rates which divide
+ *  evenly into a million, only those of 15625 Hz and more give one. This check fails
+ *  to compile if such a rate is chosen, as a reminder that the division should then
+ *  be replaced by a shift and this note removed.
+ */
+typedef char us_per_tick_is_not_a_power_of_2
+	[(US_PER_TICK & (US_PER_TICK - 1)) != 0 ? 1 : -1];
+
+
+//-------------------------------------------------------------------------------------
+/** This method sets the time stamp to the given number of microseconds. The whole 
+ *  RTOS ticks are found with one 64-bit division, which takes a while on an AVR, so
+ *  this method is meant for things such as printing a time from @c now_us(), not for
+ *  use in a timing loop. The microseconds left over are turned into hardware timer 
+ *  counts with a multiply and shift. If the time is more than about 49 days, the 
+ *  RTOS tick count in the time stamp wraps around as the RTOS's own count does. 
+ *  @param us The time in microseconds to be put into the time stamp
+ *  @return A reference to this time stamp
+ */
+
+time_stamp& time_stamp::set_from_us (uint64_t us)
+{
+	uint64_t ticks = us / US_PER_TICK;
+	uint32_t left_us = (uint32_t)(us - ticks * US_PER_TICK);
+
+	tick_count = (TickType_t)ticks;
+	hardware_count = (HW_CTR_TYPE)((left_us * US_HW_MULT) >> HW_US_SHIFT);
+
+	return (*this);
+}
@@ -1,52 +0,0 @@
-//**************************************************************************************
-/** \file time_stamp_get_us.cpp
- *    This file contains a method belonging to class \c time_stamp which returns the
- *    number of microseonds (only the fractional part, not including the integer count
- *    of seconds) in the time stamp. 
- *
- *  Revisions:
- *    \li 12-02-2012 JRR Split off from time_stamp.cpp to save memory in machine file
- *
- *  License:
- *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
- *    Public License, version 2. It intended for educational use only, but its use
- *    is not limited thereto. */
-/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
- *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
- *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
- *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
- *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
- *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
- *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
- *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
- *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
- *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
-//**************************************************************************************
-
-#include <stdlib.h>                         // Used for itoa()
-#include <string.h>                         // Header for character string functions
-#include <avr/interrupt.h>                  // For using interrupt service routines
-
-#include "FreeRTOS.h"                       // Main header for FreeRTOS 
-#include "task.h"                           // The FreeRTOS task functions header
-#include "emstream.h"                       // Base for text-type serial port objects
-#include "time_stamp.h"                     // Header for this file
-
-
-//-------------------------------------------------------------------------------------
-/** This method returns the number of microseconds in the time stamp, after the seconds
- *  are subtracted out. It is assumed that the hardware counter is ticking at an 
- *  integer number of ticks per second.
- *  @return The number of microseconds in time stamp
- */
-
-uint32_t time_stamp::get_microsec (void)
-{
-	return 
-	(
-		(int32_t)(tick_count % configTICK_RATE_HZ) * 1000000L / configTICK_RATE_HZ
-			+ (int32_t)hardware_count * 1000000L 
-				/ (configCPU_CLOCK_HZ / portCLOCK_PRESCALER)
-	);
-}
-
@@ -0,0 +1,151 @@
+//**************************************************************************************
+/** \file time_stamp_now_us.cpp
+ *    This file contains a 64-bit clock which counts microseconds since the scheduler
+ *    was started. It's kept up to date by the RTOS tick hook and is read with 
+ *    interrupts off only while the two bytes of the hardware timer are read, so it 
+ *    may be used in tasks and in interrupt service routines alike. At a microsecond
+ *    per count it won't overflow for half a million years, unlike the 32-bit RTOS 
+ *    tick count, which wraps after about 49 days.
+ *
+ *  Revisions:
+ *    \li 10-17-2026 AG  Original file
+ *    \li 10-17-2026 AG  The tick count byte is shared with the RTOS trace recorder
+ *    \li 10-17-2026 AG  The two-byte timer count is read with interrupts held off
+ *
+ *  License:
+ *    This file is copyright 2026 by agent (AG) and released under the Lesser GNU 
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include <avr/io.h>                         // For the hardware timer registers
+#include <avr/interrupt.h>                  // For cli() around the timer read
+
+#include "FreeRTOS.h"                       // Main header for FreeRTOS 
+#include "task.h"                           // The FreeRTOS task functions header
+#include "time_stamp.h"                     // Header for the time stamp constants
+#include "trace.h"                          // The trace recorder uses the tick count
+
+
+/** This check fails to compile if the RTOS tick rate doesn't divide evenly into a 
+ *  million, in which case the clock would lose part of a microsecond every tick.
+ */
+typedef char tick_rate_must_divide_1MHz
+	[(1000000UL % configTICK_RATE_HZ == 0) ? 1 : -1];
+
+/** This is the number of microseconds from the start of the scheduler to the most 
+ *  recent RTOS tick. It's only changed by the tick hook.
+ */
+static volatile uint64_t clock_base_us = 0;
+
+/** This count goes up by one each time the tick hook moves @c clock_base_us. A reader
+ *  which sees it change while reading the clock knows its reading may be half old and
+ *  half new, and reads again. One byte can be read all at once, so it needs no 
+ *  protection of its own. The RTOS trace recorder uses it as the low byte of the tick
+ *  count in its time stamps, so it has C linkage for the kernel's C files.
+ */
+extern "C"
+{
+	volatile uint8_t clock_changes = 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function is called by FreeRTOS from within the tick interrupt, once for each
+ *  RTOS tick, including ticks which occur while the scheduler is suspended. It moves
+ *  the microsecond clock forward by one tick. Interrupts are off in here, so nothing 
+ *  else can change the clock at the same time. This function needs
+ *  @c configUSE_TICK_HOOK to be set to 1 in @c FreeRTOSConfig.h.
+ */
+
+extern "C" void vApplicationTickHook (void)
+{
+	clock_base_us += US_PER_TICK;
+	clock_changes++;
+
+	// The trace's time stamps hold only the low byte of the tick count, so a record
+	// every 256 ticks lets the PC count each time that byte wraps around
+	#ifdef TASK_TRACE
+		if (clock_changes == 0)
+		{
+			trace_event (TRACE_TICK, 0);
+		}
+	#endif
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function returns the number of microseconds since the scheduler was started.
+ *  It doesn't keep interrupts off while the whole clock is read; instead it notes the
+ *  change count, reads the time of the last tick and the hardware timer, and starts 
+ *  over if the change count shows that a tick came along in the meantime. A tick 
+ *  occurs only once a millisecond, so the loop almost never runs more than twice. 
+ * 
+ *  The hardware timer count is the one thing read with interrupts off. The AVR reads
+ *  a 16-bit timer register through a TEMP register which all the timers share: the
+ *  low byte read copies the high byte into TEMP, and the high byte is then read from
+ *  TEMP. An ISR which reads a timer in between, such as one which calls this function
+ *  or the run time counter which the kernel reads while switching tasks, would leave
+ *  its own high byte in TEMP. The change count can't catch that, so interrupts are
+ *  held off for the two instructions of the read. 
+ * 
+ *  The function may be called from within an ISR, where the tick interrupt can't run.
+ *  If the hardware timer has just reached its compare match but the tick hook hasn't
+ *  run yet, the timer count has already gone back to zero; in that case the compare 
+ *  flag is still set and one tick's worth of count is added, so the clock never runs
+ *  backwards. 
+ *  @return The number of microseconds since the scheduler was started
+ */
+
+uint64_t now_us (void)
+{
+	uint8_t changes;                        // Change count before the clock was read
+	uint64_t base_us;                       // Time of the most recent RTOS tick
+	HW_CTR_TYPE hw_count;                   // Count read from the hardware timer
+	uint8_t sreg;                           // Interrupt state, saved for restoring
+
+	do
+	{
+		changes = clock_changes;
+		base_us = clock_base_us;
+
+		// Keep ISR's from using the timers' shared TEMP register during the read
+		sreg = SREG;
+		cli ();
+		#if (defined TIMER5_COMPA_vect)
+			hw_count = TCNT5;
+		#elif (defined TIMER3_COMPA_vect)
+			hw_count = TCNT3;
+		#else
+			hw_count = TCNT1;
+		#endif
+		SREG = sreg;
+
+		#if (defined TIMER5_COMPA_vect)
+			if (TIFR5 & (1 << OCF5A))
+		#elif (defined TIMER3_COMPA_vect)
+			if (TIFR3 & (1 << OCF3A))
+		#else
+			if (TIFR1 & (1 << OCF1A))
+		#endif
+			{
+				if (hw_count < (TMR_MAX_CT / 2))
+				{
+					hw_count += TMR_MAX_CT;
+				}
+			}
+	}
+	while (changes != clock_changes);
+
+	return (base_us + hw_count_to_us (hw_count));
+}
@@ -0,0 +1,97 @@
+//**************************************************************************************
+/** \file time_stamp_run_time.cpp
+ *    This file contains the function which FreeRTOS calls to read its run time 
+ *    statistics counter. The counter is made from the RTOS tick count and the same
+ *    hardware timer which class \c time_stamp reads, so no extra timer is needed.
+ *
+ *  Revisions:
+ *    \li 10-17-2026 AG  Original file
+ *
+ *  License:
+ *    This file is copyright 2026 by agent (AG) and released under the Lesser GNU 
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include <avr/io.h>                         // For the hardware timer registers
+
+#include "FreeRTOS.h"                       // Main header for FreeRTOS 
+#include "task.h"                           // The FreeRTOS task functions header
+#include "time_stamp.h"                     // Header for the time stamp constants
+
+
+//-------------------------------------------------------------------------------------
+/** This function returns the FreeRTOS run time statistics counter, which counts in
+ *  units of 1 / RUN_TIME_RATE_HZ seconds. It is called by the kernel each time the 
+ *  context is switched, so it has to be quick. Rather than multiplying the tick count
+ *  by the number of counter ticks per RTOS tick every time, it keeps a running base
+ *  count which is moved forward by RUN_TIME_PER_TICK for each RTOS tick since the 
+ *  last call; usually that's zero or one tick, which needs only an addition. The 
+ *  hardware timer count, shifted to the counter's resolution, is then added to the
+ *  base.
+ * 
+ *  If the hardware timer has just reached its compare match but the tick interrupt 
+ *  hasn't run yet because interrupts are off, the timer count has already gone back
+ *  to zero; in that case the compare flag is still set and one tick's worth of count
+ *  is added so that the counter never runs backwards.
+ *  @return The run time counter, which overflows after about five hours
+ */
+
+extern "C" uint32_t func_get_run_time_counter (void)
+{
+	static uint32_t base_count = 0;         // Run time count at base_tick
+	static TickType_t base_tick = 0;        // RTOS tick of the base count
+
+	uint16_t hw_count;                      // Count read from the hardware timer
+	TickType_t elapsed;                     // RTOS ticks since the base was moved
+	uint32_t result;                        // The run time count returned
+
+	// This is called by the kernel with interrupts off and by tasks with them on, so
+	// make sure nothing changes while the static variables are updated
+	portENTER_CRITICAL ();
+
+	#if (defined TIMER5_COMPA_vect)
+		hw_count = TCNT5;
+		if (TIFR5 & (1 << OCF5A))
+	#elif (defined TIMER3_COMPA_vect)
+		hw_count = TCNT3;
+		if (TIFR3 & (1 << OCF3A))
+	#else
+		hw_count = TCNT1;
+		if (TIFR1 & (1 << OCF1A))
+	#endif
+		{
+			if (hw_count < (TMR_MAX_CT / 2))
+			{
+				hw_count += TMR_MAX_CT;
+			}
+		}
+
+	// Move the base count forward to the current tick. A multiplication is only
+	// needed if no context switch has occurred for more than one tick
+	elapsed = xTaskGetTickCount () - base_tick;
+	if (elapsed == 1)
+	{
+		base_count += RUN_TIME_PER_TICK;
+	}
+	else if (elapsed != 0)
+	{
+		base_count += elapsed * RUN_TIME_PER_TICK;
+	}
+	base_tick += elapsed;
+	result = base_count + (hw_count >> RUN_TIME_SHIFT);
+
+	portEXIT_CRITICAL ();
+
+	return (result);
+}
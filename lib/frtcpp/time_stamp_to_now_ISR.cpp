@@ -6,6 +6,7 @@
  *
  *  Revisions:
  *    \li 12-02-2012 JRR Split off from time_stamp.cpp to save memory in machine file
+ *    \li 10-17-2026 AG  Reads Timer 5 when the RTOS tick uses it, as set_to_now() does
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -46,7 +47,9 @@ void time_stamp::set_to_now_in_ISR (void)
 
 	// Now grab the hardware timer count. The tick count can't be updated, even if the
 	// hardware timer overflows, because interrupts are disabled
-	#ifdef TIMER3_COMPA_vect
+	#if (defined TIMER5_COMPA_vect)
+		hardware_count = TCNT5;
+	#elif (defined TIMER3_COMPA_vect)
 		hardware_count = TCNT3;
 	#else
 		hardware_count = TCNT1;
@@ -0,0 +1,280 @@
+//*************************************************************************************
+/** \file trace.cpp
+ *    This file contains the parts of the RTOS trace recorder which aren't needed for
+ *    each event: the ring buffer itself, the tables of task and ISR names, and the
+ *    code which sends a frozen buffer to the PC as telemetry frames. Nothing in here
+ *    is compiled unless @c TASK_TRACE is defined in the Makefile.
+ *
+ *  Revised:
+ *    \li 10-17-2026 AG  Original file
+ *    \li 10-17-2026 AG  Frame payloads are built in a static buffer, not on the stack
+ *
+ *  License:
+ *		This file is copyright 2026 by agent (AG) and released under the Lesser GNU
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * 		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * 		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * 		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ * 		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * 		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * 		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * 		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * 		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+#include <string.h>                         // For memcpy(), strlen() and memset()
+
+#include "FreeRTOS.h"                       // Main header for FreeRTOS
+#include "task.h"                           // The FreeRTOS task functions header
+#include "time_stamp.h"                     // Hardware timer counts per tick and rate
+#include "telemetry.h"                      // Frames which carry the trace to the PC
+#include "trace.h"                          // Header for this file
+
+
+#ifdef TASK_TRACE
+
+/** This check fails to compile if the ring buffer's size isn't a power of two which
+ *  a one-byte index can reach, as the index is wrapped with a mask.
+ */
+typedef char trace_records_must_be_power_of_2
+	[((TRACE_RECORDS & (TRACE_RECORDS - 1)) == 0 && TRACE_RECORDS <= 256) ? 1 : -1];
+
+/** This check fails to compile if one RTOS tick's worth of hardware timer counts,
+ *  shifted right by @c TRACE_SHIFT bits, doesn't fit in the low byte of a time stamp.
+ */
+typedef char trace_tick_must_fit_in_a_byte
+	[((TMR_MAX_CT >> TRACE_SHIFT) <= 256) ? 1 : -1];
+
+/// This is the version of the trace frames' layout, sent in the start frame.
+const uint8_t TRACE_VERSION = 1;
+
+/// This is the number of records which fit in one frame after the frame code.
+const uint8_t TRACE_PER_FRAME = (TELEM_MAX_PAYLOAD - 1) / sizeof (trace_record);
+
+
+/** @brief   The payload of the frame which begins each trace dump.
+ *  @details It tells the PC how to turn time stamps into microseconds. The fields are
+ *           little-endian with no padding on both the AVR and the PC.
+ */
+struct trace_start_frame
+{
+	uint8_t code;                           ///< @c TRACE_FRAME_START
+	uint8_t version;                        ///< @c TRACE_VERSION
+	uint16_t records;                       ///< Size of the ring buffer in records
+	uint8_t shift;                          ///< Timer count shift, @c TRACE_SHIFT
+	uint16_t counts_per_tick;               ///< Hardware timer counts per RTOS tick
+	uint32_t counts_per_second;             ///< Hardware timer counts per second
+} __attribute__ ((packed));
+
+
+// The variables used by the inline recording functions in trace.h must have C
+// linkage, as those functions are also compiled into the kernel's C files
+extern "C"
+{
+	/// The ring buffer of records. It starts out all zeros, which are empty records.
+	trace_record trace_buffer[TRACE_RECORDS];
+
+	/// The index in @c trace_buffer at which the next record will be written.
+	uint8_t trace_head = 0;
+
+	/// This is nonzero while records are being kept, and zero while they're frozen.
+	volatile uint8_t trace_on = 1;
+
+	/// The number of the task most recently switched out, kept by the kernel's hooks.
+	uint8_t trace_last_task = 0;
+
+	/// The number of queues, semaphores and mutexes which have been given numbers.
+	uint8_t trace_queues = 0;
+}
+
+/// The names of the tasks, saved as they're created, with the task numbers as indices.
+static const char* task_names[TRACE_TASKS];
+
+/// The names of ISR's which have been given names with @c trace_name_isr().
+static const char* isr_names[TRACE_ISRS];
+
+/// This is set when the buffer is frozen, and cleared after the buffer has been sent.
+static volatile bool dump_wanted = false;
+
+/** The payload of each name, record and end frame is put together here. It's kept off
+ *  the stack of the task which sends the dump, and as only that task uses it, it needs
+ *  no protection.
+ */
+static uint8_t payload[TELEM_MAX_PAYLOAD];
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Save the name of a newly created task.
+ *  @details This function is called from the kernel's @c traceTASK_CREATE() hook. The
+ *           name is kept in the task's control block, which is never freed because
+ *           tasks aren't deleted, so only a pointer to it is saved.
+ *  @param   number The task's number, which FreeRTOS gives it as it's created
+ *  @param   p_name A pointer to the task's name in its task control block
+ */
+
+extern "C" void trace_task_created (uint8_t number, const char* p_name)
+{
+	if (number < TRACE_TASKS)
+	{
+		task_names[number] = p_name;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Stop recording so that the buffer can be sent to the PC.
+ *  @details This function freezes the buffer, keeping the events which led up to the
+ *           moment it's called, and asks for the buffer to be sent. The telemetry
+ *           task sends it through @c trace_send(), after which recording starts again.
+ *           It may be called from a task or an ISR, for example when something goes
+ *           wrong whose causes are to be found.
+ */
+
+void trace_freeze (void)
+{
+	trace_on = 0;
+	dump_wanted = true;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Give a name to an ISR number used with @c TRACE_ISR_ENTER().
+ *  @details The name is sent to the PC with each dump, so that the ISR's row in the
+ *           timeline has a name rather than a number. Only a pointer is saved, so the
+ *           name must be a string in RAM which is never changed or freed.
+ *  @param   id The number, from 0 to @c TRACE_ISRS - 1, used in the ISR's macros
+ *  @param   p_name The name which is shown for the ISR
+ */
+
+void trace_name_isr (uint8_t id, const char* p_name)
+{
+	if (id < TRACE_ISRS)
+	{
+		isr_names[id] = p_name;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Send a frame giving the name of a task or ISR.
+ *  @details The name is cut short if it doesn't fit in one frame.
+ *  @param   p_link The telemetry link through which the frame is sent
+ *  @param   kind What's being named, @c TRACE_NAME_TASK or @c TRACE_NAME_ISR
+ *  @param   number The task's or ISR's number
+ *  @param   p_name The name
+ */
+
+static void send_name (telemetry_link* p_link, uint8_t kind, uint8_t number,
+					   const char* p_name)
+{
+	uint8_t length = strlen (p_name);
+
+	if (length > TELEM_MAX_PAYLOAD - 3)
+	{
+		length = TELEM_MAX_PAYLOAD - 3;
+	}
+	payload[0] = TRACE_FRAME_NAME;
+	payload[1] = kind;
+	payload[2] = number;
+	memcpy (payload + 3, p_name, length);
+	p_link->send (TELEM_TRACE, payload, length + 3);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Send the trace buffer to the PC if it has been frozen.
+ *  @details If @c trace_freeze() hasn't been called, this function does nothing, so
+ *           the telemetry task can call it every period. Otherwise it sends a start
+ *           frame, the names of the tasks and ISR's, the records from oldest to
+ *           newest, packed into as few frames as possible, and an end frame with the
+ *           number of records sent. No records are written while the buffer is frozen,
+ *           so it needn't be protected while it's sent. Then the buffer is emptied and
+ *           recording starts again. Only one task may call this function.
+ *  @param   p_link The telemetry link through which the frames are sent
+ *  @return  The number of frames which were sent
+ */
+
+uint8_t trace_send (telemetry_link* p_link)
+{
+	trace_start_frame start;
+	uint8_t frames = 0;
+	uint8_t length = 1;                     // Bytes in the payload, after the code
+	uint16_t sent = 0;                      // Number of records sent
+
+	if (!dump_wanted)
+	{
+		return (0);
+	}
+
+	start.code = TRACE_FRAME_START;
+	start.version = TRACE_VERSION;
+	start.records = TRACE_RECORDS;
+	start.shift = TRACE_SHIFT;
+	start.counts_per_tick = TMR_MAX_CT;
+	start.counts_per_second = HW_TICK_RATE_HZ;
+	p_link->send (TELEM_TRACE, start);
+	frames++;
+
+	for (uint8_t index = 0; index < TRACE_TASKS; index++)
+	{
+		if (task_names[index] != NULL)
+		{
+			send_name (p_link, TRACE_NAME_TASK, index, task_names[index]);
+			frames++;
+		}
+	}
+	for (uint8_t index = 0; index < TRACE_ISRS; index++)
+	{
+		if (isr_names[index] != NULL)
+		{
+			send_name (p_link, TRACE_NAME_ISR, index, isr_names[index]);
+			frames++;
+		}
+	}
+
+	// The oldest record is the one which would be written next. Empty records are
+	// skipped, so a buffer which hasn't yet gone all the way around starts at zero
+	payload[0] = TRACE_FRAME_RECORDS;
+	for (uint16_t count = 0; count < TRACE_RECORDS; count++)
+	{
+		const trace_record* p_record
+			= trace_buffer + ((trace_head + count) & (TRACE_RECORDS - 1));
+
+		if (p_record->type != TRACE_NONE)
+		{
+			memcpy (payload + length, p_record, sizeof (trace_record));
+			length += sizeof (trace_record);
+			sent++;
+			if (length == 1 + TRACE_PER_FRAME * sizeof (trace_record))
+			{
+				p_link->send (TELEM_TRACE, payload, length);
+				frames++;
+				length = 1;
+			}
+		}
+	}
+	if (length > 1)
+	{
+		p_link->send (TELEM_TRACE, payload, length);
+		frames++;
+	}
+
+	payload[0] = TRACE_FRAME_END;
+	memcpy (payload + 1, &sent, sizeof (sent));
+	p_link->send (TELEM_TRACE, payload, 1 + sizeof (sent));
+	frames++;
+
+	// Empty the buffer and start recording again
+	memset (trace_buffer, 0, sizeof (trace_buffer));
+	trace_head = 0;
+	trace_last_task = 0;
+	dump_wanted = false;
+	trace_on = 1;
+
+	return (frames);
+}
+
+#endif  // TASK_TRACE
@@ -0,0 +1,243 @@
+//*************************************************************************************
+/** \file trace.h
+ *    This file contains a recorder which keeps a timeline of what the RTOS is doing:
+ *    which task is running, which queues, semaphores and mutexes are used, and when
+ *    chosen interrupt service routines run. FreeRTOS calls the recorder through its
+ *    trace hook macros, which are defined in @c FreeRTOSConfig.h, and ISRs call it
+ *    through @c TRACE_ISR_ENTER() and @c TRACE_ISR_EXIT(). Each event is written as a
+ *    four-byte record into a ring buffer in RAM, which always holds the newest events.
+ *    When the buffer is frozen, it's sent to the PC as telemetry frames, and the PC
+ *    turns it into a timeline which can be viewed in a web browser. Unless
+ *    @c TASK_TRACE is defined in the Makefile, the hooks and macros produce no code
+ *    and the buffer takes no memory.
+ *
+ *    This file is included by the kernel's C files as well as by C++ files, so the
+ *    parts which the kernel uses are written in C.
+ *
+ *  Revised:
+ *    \li 10-17-2026 AG  Original file
+ *    \li 10-17-2026 AG  Moved the event and frame codes to telem_protocol.h
+ *
+ *  License:
+ *		This file is copyright 2026 by agent (AG) and released under the Lesser GNU
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * 		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * 		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * 		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ * 		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * 		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * 		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * 		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * 		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <stdint.h>                         // Standard size integer types
+#include <avr/io.h>                         // For the hardware timer registers
+#include <avr/interrupt.h>                  // For cli(), used around each record
+#include "telem_protocol.h"                 // Event codes, shared with the PC decoder
+
+
+/** This is the number of records in the ring buffer. It must be a power of two no
+ *  larger than 256. Each record takes four bytes of RAM.
+ */
+#ifndef TRACE_RECORDS
+	#define TRACE_RECORDS       128
+#endif
+
+/** This is the number of task names which are kept for the PC, and one more than the
+ *  largest task number whose name is kept. FreeRTOS numbers tasks from 1 as they're
+ *  created, including the idle task.
+ */
+#define TRACE_TASKS             16
+
+/** This is the number of ISR names which can be given with @c trace_name_isr(). */
+#define TRACE_ISRS              4
+
+/** The hardware timer count is shifted right by this many bits to fit in the low
+ *  byte of each record's time stamp. With 2000 counts per RTOS tick, the low byte
+ *  counts from 0 to 249 in units of 4 microseconds.
+ */
+#define TRACE_SHIFT             3
+
+// The timer which runs the RTOS tick, as chosen in port.c and time_stamp.h
+#if (defined TIMER5_COMPA_vect)
+	#define TRACE_TCNT          TCNT5
+	#define TRACE_OCR           OCR5A
+	#define TRACE_MATCHED       (TIFR5 & (1 << OCF5A))
+#elif (defined TIMER3_COMPA_vect)
+	#define TRACE_TCNT          TCNT3
+	#define TRACE_OCR           OCR3A
+	#define TRACE_MATCHED       (TIFR3 & (1 << OCF3A))
+#else
+	#define TRACE_TCNT          TCNT1
+	#define TRACE_OCR           OCR1A
+	#define TRACE_MATCHED       (TIFR1 & (1 << OCF1A))
+#endif
+
+
+/** @brief   One event in the trace buffer.
+ *  @details The time stamp's high byte is the low byte of the RTOS tick count, and its
+ *           low byte is the hardware timer count shifted right by @c TRACE_SHIFT bits.
+ *           The PC puts the ticks back together, counting a wrap of the high byte
+ *           each time it goes down; a @c TRACE_TICK record every 256 ticks makes sure
+ *           no wrap is missed.
+ */
+typedef struct
+{
+	uint8_t type;                           ///< Which kind of event, @c TRACE_xxx
+	uint8_t arg;                            ///< Task, queue or ISR number
+	uint16_t stamp;                         ///< Time stamp, tick and timer count
+} __attribute__ ((packed)) trace_record;
+
+
+#ifdef TASK_TRACE
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern trace_record trace_buffer[];         // The ring buffer of records
+extern uint8_t trace_head;                  // Where the next record will be written
+extern volatile uint8_t trace_on;           // Nonzero while records are being kept
+extern uint8_t trace_last_task;             // Number of the task being switched out
+extern uint8_t trace_queues;                // Number of queues given numbers so far
+extern volatile uint8_t clock_changes;      // Counts RTOS ticks; see now_us()
+
+// Called from the kernel when a task is created, to save its name for the PC
+void trace_task_created (uint8_t number, const char* p_name);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+//-------------------------------------------------------------------------------------
+/** This function writes one record into the trace buffer unless the buffer is frozen.
+ *  It's inline and works only on single bytes and one 16-bit timer count, so it takes
+ *  a few dozen cycles. The clock is read as in @c now_us(): if the timer has reached
+ *  its compare match but the tick interrupt hasn't run yet, the count has gone back
+ *  to zero, so the tick is counted here. Interrupts are held off while the record is
+ *  written, as the kernel calls some of its hooks with them on.
+ *  @param type The kind of event, one of the @c TRACE_xxx codes
+ *  @param arg The number of the task, queue or ISR to which the event happened
+ */
+
+static inline void trace_event (uint8_t type, uint8_t arg)
+{
+	uint8_t sreg = SREG;
+	cli ();
+
+	if (trace_on)
+	{
+		uint8_t tick = clock_changes;
+		uint16_t count = TRACE_TCNT;
+		if (TRACE_MATCHED && count < (TRACE_OCR >> 1))
+		{
+			tick++;
+		}
+
+		trace_record* p_record = trace_buffer + trace_head;
+		p_record->type = type;
+		p_record->arg = arg;
+		p_record->stamp = ((uint16_t)tick << 8) | (uint8_t)(count >> TRACE_SHIFT);
+		trace_head = (trace_head + 1) & (TRACE_RECORDS - 1);
+	}
+
+	SREG = sreg;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function is called by the kernel before it chooses the next task to run. It
+ *  only notes which task was running; the switch is recorded when the next task is
+ *  switched in, and only if it's a different task, so the idle task being switched
+ *  out and back in every tick doesn't fill the buffer.
+ *  @param task The number of the task which is being switched out
+ */
+
+static inline void trace_switched_out (uint8_t task)
+{
+	trace_last_task = task;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function is called by the kernel when a task has been chosen to run. It
+ *  writes a record if the task isn't the one which was just switched out; the end of
+ *  the previous task's run is the beginning of this one's.
+ *  @param task The number of the task which is being switched in
+ */
+
+static inline void trace_switched_in (uint8_t task)
+{
+	if (task != trace_last_task)
+	{
+		trace_event (TRACE_SWITCH, task);
+	}
+}
+
+
+/** @brief   Macros which mark the beginning and end of an ISR in the trace.
+ *  @details Put @c TRACE_ISR_ENTER(id) at the top of an ISR and @c TRACE_ISR_EXIT(id)
+ *           at its bottom, where @c id is a number from 0 to @c TRACE_ISRS - 1 which
+ *           may be given a name with @c trace_name_isr(). If @c TASK_TRACE isn't
+ *           defined, they produce no code.
+ */
+#define TRACE_ISR_ENTER(id)     trace_event (TRACE_ISR_BEGIN, (id))
+#define TRACE_ISR_EXIT(id)      trace_event (TRACE_ISR_END, (id))
+
+#else  // TASK_TRACE isn't defined
+
+#define TRACE_ISR_ENTER(id)
+#define TRACE_ISR_EXIT(id)
+
+#endif  // TASK_TRACE
+
+
+// The rest of this file is for C++ code only, as the kernel doesn't use it
+#ifdef __cplusplus
+
+// The class which sends the trace is declared in telemetry.h. That header isn't
+// included here because this file is included by FreeRTOSConfig.h
+class telemetry_link;
+
+#ifdef TASK_TRACE
+
+// Stop recording so that the buffer can be sent to the PC
+void trace_freeze (void);
+
+// Give a name to an ISR number used with TRACE_ISR_ENTER() and TRACE_ISR_EXIT()
+void trace_name_isr (uint8_t id, const char* p_name);
+
+// If the buffer has been frozen, send it through a telemetry link and start again
+uint8_t trace_send (telemetry_link* p_link);
+
+#else
+
+/** When tracing isn't compiled in, there's nothing to freeze. */
+inline void trace_freeze (void) { }
+
+/** When tracing isn't compiled in, ISR names aren't kept.
+ *  @param id The ISR's number
+ *  @param p_name The ISR's name
+ */
+inline void trace_name_isr (uint8_t id, const char* p_name) { (void)id; (void)p_name; }
+
+/** When tracing isn't compiled in, there's never a trace to be sent.
+ *  @param p_link The telemetry link which would carry the trace
+ *  @return Zero, the number of frames sent
+ */
+inline uint8_t trace_send (telemetry_link* p_link) { (void)p_link; return (0); }
+
+#endif  // TASK_TRACE
+
+#endif  // __cplusplus
+
+#endif  // _TRACE_H_
@@ -8,6 +8,7 @@
  *  Revised:
  *    \li 10-21-2012 JRR Original file, class \c frt_text_queue
  *    \li 12-16-2012 JRR Made into the unsafe text queue to use for testing
+ *    \li 10-17-2026 AG  Added write(); putchar() and getchar() match emstream's
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -93,17 +94,21 @@ class unsafe_text_queue : public emstream
 		circ_buffer<char, size>* p_buffer;
 
 		/// The number of RTOS ticks to wait on a full buffer before giving up.
-		portTickType ticks_to_wait;
+		TickType_t ticks_to_wait;
 
 	// Public methods can be called from anywhere in the program where there is a 
 	// pointer or reference to an object of this class
 	public:
 		// The constructor creates a circular buffer to hold the data
-		unsafe_text_queue (emstream* = NULL, portTickType = portMAX_DELAY);
+		unsafe_text_queue (emstream* = NULL, TickType_t = portMAX_DELAY);
+
+		void putchar (char);					// Write one character to the queue
+
+		// Write a block of characters to the queue
+		uint16_t write (const char* p_data, uint16_t count);
 
-		bool putchar (char);					// Write one character to the queue
 		bool check_for_char (void);			// Check if a character is in the queue
-		int16_t getchar (void);				// Read a character from the queue
+		char getchar (void);					// Read a character from the queue
 
 		/** This overloaded boolean operator allows one to check if the queue has any
 		 *  contents which can be read by just checking if the queue is true. It might
@@ -141,7 +146,7 @@ class unsafe_text_queue : public emstream
 
 template <size_t size>
 unsafe_text_queue<size>::unsafe_text_queue (emstream* p_ser_dev,
-										   portTickType a_wait_time)
+										   TickType_t a_wait_time)
 {
 	// Save the pointer to the serial device which is used for debugging
 	p_serial = p_ser_dev;
@@ -166,30 +171,50 @@ unsafe_text_queue<size>::unsafe_text_queue (emstream* p_ser_dev,
 
 
 //-------------------------------------------------------------------------------------
-/** This method writes one character to the queue. If the second constructor parameter
- *  wasn't given, the write operation will block until there is room in the queue for
- *  the character being written. Otherwise, the write will block for the given number
- *  of RTOS ticks waiting for an empty space in the queue, then if the queue has not
- *  become empty, give up in frustration and return false. 
+/** This method writes one character to the queue. It just calls \c write() to write
+ *  a block which is one character long. 
  *  @param a_char The character to be sent to the queue
- *  @return True if the character was successfully sent, false if something went wrong
  */
 
 template <size_t size>
-bool unsafe_text_queue<size>::putchar (char a_char)
+inline void unsafe_text_queue<size>::putchar (char a_char)
 {
-	for (portTickType tick_count = ticks_to_wait; tick_count > 0; tick_count--)
+	write (&a_char, 1);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method writes a block of characters to the queue. Since there is no 
+ *  protection from interruption, the characters are just put into the circular buffer
+ *  one after another without the overhead of a virtual \c putchar() call for each. 
+ *  If the buffer is full, each character is retried up to the number of times given
+ *  as the second constructor parameter; if it still won't fit, this method gives up 
+ *  in frustration and the rest of the characters aren't written. 
+ *  @param p_data Pointer to the characters to be written
+ *  @param count The number of characters to write
+ *  @return The number of characters which were successfully written
+ */
+
+template <size_t size>
+uint16_t unsafe_text_queue<size>::write (const char* p_data, uint16_t count)
+{
+	for (uint16_t done = 0; done < count; done++)
 	{
 		// If the circular buffer's put() method returns true, the character was
-		// successfully placed in the buffer and we're done
-		if (p_buffer->put (a_char))
+		// successfully placed in the buffer and we can go on to the next one
+		for (TickType_t tries = ticks_to_wait; ; tries--)
 		{
-			return (true);
+			if (tries == 0)
+			{
+				return (done);
+			}
+			if (p_buffer->put (p_data[done]))
+			{
+				break;
+			}
 		}
 	}
-
-	// If we get here, the loop timed out and data wasn't saved
-	return (false);
+	return (count);
 }
 
 
@@ -228,7 +253,7 @@ inline bool unsafe_text_queue<size>::check_for_char (void)
  */
 
 template <size_t size>
-inline int16_t unsafe_text_queue<size>::getchar (void)
+inline char unsafe_text_queue<size>::getchar (void)
 {
 	return (p_buffer->get ());
 }
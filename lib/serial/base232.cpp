@@ -20,6 +20,8 @@
  *    \li 12-22-2008 JRR Split off stuff in base232.h for efficiency
  *    \li 01-30-2009 JRR Added class with port setup in constructor
  *    \li 06-02-2009 JRR Changed baud rate divisor formula to work better
+ *    \li 10-17-2026 AG  Baud rate divisor and double speed mode chosen for the least
+ *                       error; the full 12-bit divisor is used
  *
  *  License:
  *    This file is released under the Lesser GNU Public License, version 2. This 
@@ -44,7 +46,10 @@
 /** This method sets up the AVR UART for communications.  It enables the appropriate 
  *  inputs and outputs and sets the baud rate divisor, and it saves pointers to the
  *  registers which are used to operate the serial port. Since some AVR processors
- *  have dual serial ports, this method allows one to specify a port number. 
+ *  have dual serial ports, this method allows one to specify a port number. The baud 
+ *  rate divisor and the double speed (U2X) bit are chosen to give the smallest error
+ *  in the baud rate; the error is saved so that it can be checked with 
+ *  \c get_baud_error(). 
  *  @param baud_rate The desired baud rate for serial communications. Default is 9600
  *  @param port_number The number of the serial port, 0 or 1 (the second port numbered
  *                     1 only exists on some processors). The default is port 0 
@@ -52,8 +57,13 @@
 
 // This section compiles for the AVR microcontroller
 #ifdef __AVR
-base232::base232 (unsigned int baud_rate, unsigned char port_number)
+base232::base232 (uint32_t baud_rate, unsigned char port_number)
 {
+	// Work out the most accurate divisor and whether double speed mode is needed
+	bool use_2x = UART_USE_2X (baud_rate);
+	uint16_t divisor = use_2x ? UART_UBRR_2X (baud_rate) : UART_UBRR_1X (baud_rate);
+	baud_error = use_2x ? UART_ERROR_2X (baud_rate) : UART_ERROR_1X (baud_rate);
+
 	// If we're compiling for a chip with UCSR0A defined, it has dual serial ports
 	// (examples are ATmega324P and ATmega128). Set up Port 0 or Port 1
 	#if defined UCSR0A
@@ -64,11 +74,9 @@ base232::base232 (unsigned int baud_rate, unsigned char port_number)
 			p_UCR = &UCSR0B;
 			UCSR0B = (1 << RXEN0) | (1 << TXEN0);
 			UCSR0C = (1 << UCSZ01) | (1 << UCSZ00); // | (1 << USBS0);
-			UBRR0H = 0x00;
-			UBRR0L = calc_baud_div (baud_rate);
-			#ifdef UART_DOUBLE_SPEED					// Activate double speed mode
-				UCSR0A |= U2X0;							// if required
-			#endif
+			UBRR0H = (uint8_t)(divisor >> 8);
+			UBRR0L = (uint8_t)divisor;
+			UCSR0A = use_2x ? (1 << U2X0) : 0;		// Double speed mode if needed
 			mask_UDRE = (1 << UDRE0);
 			mask_RXC = (1 << RXC0);
 			mask_TXC = (1 << TXC0);
@@ -81,11 +89,9 @@ base232::base232 (unsigned int baud_rate, unsigned char port_number)
 			p_UCR = &UCSR1B;
 			UCSR1B = (1 << RXEN1) | (1 << TXEN1);
 			UCSR1C = (1 << UCSZ11) | (1 << UCSZ10); // | (1 << USBS1);
-			UBRR1H = 0x00;
-			UBRR1L = calc_baud_div (baud_rate);
-			#ifdef UART_DOUBLE_SPEED		// If double-speed macro has been defined,
-				UCSR1A |= U2X1;				// turn on double-speed operation
-			#endif
+			UBRR1H = (uint8_t)(divisor >> 8);
+			UBRR1L = (uint8_t)divisor;
+			UCSR1A = use_2x ? (1 << U2X1) : 0;		// Double speed mode if needed
 			mask_UDRE = (1 << UDRE1);
 			mask_RXC = (1 << RXC1);
 			mask_TXC = (1 << TXC1);
@@ -102,11 +108,9 @@ base232::base232 (unsigned int baud_rate, unsigned char port_number)
 			p_UCR = &UCSRB;
 			UCSRB = (1 << RXEN) | (1 << TXEN);
 			UCSRC = (1 << URSEL) | (1 << UCSZ1) | (1 << UCSZ0);		// | (1 << USBS0);
-			UBRRH = 0x00;
-			UBRRL = calc_baud_div (baud_rate);
-			#ifdef UART_DOUBLE_SPEED				// Activate double speed mode
-				UCSRA |= U2X;						// if required
-			#endif
+			UBRRH = (uint8_t)(divisor >> 8);		// URSEL is 0, so this is UBRRH
+			UBRRL = (uint8_t)divisor;
+			UCSRA = use_2x ? (1 << U2X) : 0;		// Double speed mode if needed
 			mask_UDRE = (1 << UDRE);
 			mask_RXC = (1 << RXC);
 			mask_TXC = (1 << TXC);
@@ -116,7 +120,8 @@ base232::base232 (unsigned int baud_rate, unsigned char port_number)
 			p_USR = &USR;
 			p_UCR = &UCR;
 			UCR = (1 << RXEN) | (1 << TXEN);		// 0x18 for mode N81
-			UBRR = calc_baud_div (baud_rate);
+			UBRR = (uint8_t)UART_UBRR_1X (baud_rate);	// No U2X or high byte here
+			baud_error = UART_ERROR_1X (baud_rate);
 			mask_UDRE = (1 << UDRE);
 			mask_RXC = (1 << RXC);
 			mask_TXC = (1 << TXC);
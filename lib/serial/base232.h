@@ -21,6 +21,9 @@
  *    \li 01-30-2009 JRR Added class with port setup in constructor
  *    \li 06-02-2009 JRR Changed baud rate divisor formula to work better
  *    \li 12-14-2009 JRR Changed CPU_FREQ_Hz to F_CPU to be compatible with avr-libc
+ *    \li 10-17-2026 AG  Baud rate divisor and double speed mode chosen for the least
+ *                       error, with 12-bit divisors for rates from 300 to 1M baud
+ *    \li 10-17-2026 AG  UART_CHECK_BAUD() names its check by line, not by rate
  *
  *  License:
  *    This file is released under the Lesser GNU Public License, version 2. This 
@@ -32,6 +35,7 @@
 #ifndef _BASE232_H_
 #define _BASE232_H_
 
+#include <stdint.h>							// Standard size integer types
 // #include "emstream.h"				// Pull in the base class header file
 
 // Check that the user has set the CPU frequency in the Makefile; if not, complain
@@ -44,25 +48,65 @@
 #define UART_TX_TOUT		20000
 
 //-------------------------------------------------------------------------------------
-/** If this macro is defined, the UART will run in double-speed mode. This is often
- *  a good idea, as it allows higher baud rates to be used with not so high CPU clock
- *  frequencies. 
+/** This is the largest error between the requested baud rate and the rate the UART 
+ *  can really make, in tenths of a percent, which is considered acceptable. Receivers
+ *  usually cope with about 2%; since both ends of a link may be off, we ask for that
+ *  much at most. It can be changed in the Makefile. 
  */
-#define UART_DOUBLE_SPEED
+#ifndef UART_MAX_BAUD_ERROR
+	#define UART_MAX_BAUD_ERROR	20
+#endif
+
+/// The largest baud rate divisor which fits in the 12-bit UBRR register
+#define UART_UBRR_MAX		4095UL
 
 //-------------------------------------------------------------------------------------
-/** This macro computes a value for the baud rate divisor from the desired baud rate 
- *  and the CPU clock frequency. The CPU clock frequency should have been set in the 
- *  macro F_CPU, which is normally configured in the Makefile. The divisor is
- *  calculated as (frequency, MHz / (16 * baudrate)), unless the USART is running in
- *  double-speed mode, in which case the baud rate divisor is twice as big. 
+/** These macros compute values for the baud rate divisor from the desired baud rate 
+ *  and the CPU clock frequency, rounded to the nearest integer, at normal speed 
+ *  (16 clock cycles per bit) and at double speed with the U2X bit set (8 cycles per 
+ *  bit). The CPU clock frequency should have been set in the macro F_CPU, which is
+ *  normally configured in the Makefile. A rate too fast for a mode gives a divisor
+ *  much larger than \c UART_UBRR_MAX, which marks the mode as unusable. 
  */
+#define UART_UBRR_1X(baud)	((((F_CPU) + 8UL * (baud)) / (16UL * (baud))) - 1UL)
+#define UART_UBRR_2X(baud)	((((F_CPU) + 4UL * (baud)) / (8UL * (baud))) - 1UL)
 
-#ifdef UART_DOUBLE_SPEED
-	#define calc_baud_div(baud_rate) ((F_CPU) / (16UL * (baud_rate)))
-#else
-	#define calc_baud_div(baud_rate) ((F_CPU) / (8UL * (baud_rate)))
-#endif
+/// This macro computes the absolute error between two rates in tenths of a percent
+#define UART_ERROR(actual, baud) \
+	(((actual) > (baud) ? (actual) - (baud) : (baud) - (actual)) * 1000UL / (baud))
+
+/// These macros compute the error of each mode, or 1000 if the mode can't be used
+#define UART_ERROR_1X(baud) (UART_UBRR_1X (baud) > UART_UBRR_MAX ? 1000UL \
+	: UART_ERROR ((F_CPU) / (16UL * (UART_UBRR_1X (baud) + 1UL)), (baud)))
+#define UART_ERROR_2X(baud) (UART_UBRR_2X (baud) > UART_UBRR_MAX ? 1000UL \
+	: UART_ERROR ((F_CPU) / (8UL * (UART_UBRR_2X (baud) + 1UL)), (baud)))
+
+//-------------------------------------------------------------------------------------
+/** These macros choose between normal and double speed for a given baud rate. Double 
+ *  speed is only used when it's more accurate, because at normal speed the receiver
+ *  takes more samples of each bit and is less bothered by noise. For a constant baud 
+ *  rate they are integer constant expressions, so the compiler works them out; the
+ *  \c base232 constructor uses the same macros to set up the UART. 
+ */
+#define UART_USE_2X(baud)	(UART_ERROR_2X (baud) < UART_ERROR_1X (baud))
+#define UART_UBRR(baud)		(UART_USE_2X (baud) ? UART_UBRR_2X (baud) \
+									: UART_UBRR_1X (baud))
+#define UART_BAUD_ERROR(baud) (UART_USE_2X (baud) ? UART_ERROR_2X (baud) \
+									: UART_ERROR_1X (baud))
+
+/** This macro refuses to compile a program which uses a baud rate that can't be made 
+ *  within \c UART_MAX_BAUD_ERROR from the CPU clock. Put it at file scope next to
+ *  the code which creates the serial port, for example \c UART_CHECK_BAUD(38400).
+ *  The rate may be given by a macro. The name of the check is made from the line 
+ *  number rather than the rate, so that a rate such as \c 500000UL can be checked 
+ *  and checks in one file don't collide; the extra macros make \c __LINE__ turn into
+ *  a number before it's pasted onto the name.
+ */
+#define UART_CHECK_BAUD(baud)	UART_CHECK_BAUD_AT (baud, __LINE__)
+#define UART_CHECK_BAUD_AT(baud, line)	UART_CHECK_BAUD_NAMED (baud, line)
+#define UART_CHECK_BAUD_NAMED(baud, line) \
+	typedef char baud_rate_error_too_large_at_line_##line \
+	[(UART_BAUD_ERROR (baud) <= UART_MAX_BAUD_ERROR) ? 1 : -1]
 
 
 //-------------------------------------------------------------------------------------
@@ -100,6 +144,8 @@ class base232
 
 		/// This bitmask identifies the bit for transmission complete, TXC
 		unsigned char mask_TXC;
+		/// The error in the baud rate actually used, in tenths of a percent
+		uint16_t baud_error;
 	#else
 		/// This is the file handle for the serial port file device on a PC
 		int serial_file;
@@ -108,7 +154,7 @@ class base232
 	public:
 	#ifdef __AVR
 		/// The constructor sets up the port with the given baud rate and port number.
-		base232 (unsigned int = 9600, unsigned char = 0);
+		base232 (uint32_t = 9600, unsigned char = 0);
 	#else
 		/// The constructor sets up the port with the given name.
 		base232 (char*);
@@ -119,6 +165,18 @@ class base232
 
 		/// This method returns true if the port is currently sending a character out.
 		bool is_sending (void);
+
+	#ifdef __AVR
+		/** This method returns the difference between the baud rate which was asked
+		 *  for and the one the UART is really using. If it's more than 
+		 *  \c UART_MAX_BAUD_ERROR, communication is likely to be unreliable. 
+		 *  @return The baud rate error in tenths of a percent
+		 */
+		uint16_t get_baud_error (void)
+		{
+			return (baud_error);
+		}
+	#endif
 };
 
 #endif  // _BASE232_H_
@@ -0,0 +1,138 @@
+//*************************************************************************************
+/** \file dlog.cpp
+ *    This file contains a queue which holds deferred-format log records and packs 
+ *    them into telemetry frames.
+ *
+ *  Revised:
+ *    \li 10-17-2026 AG  Original file
+ *    \li 10-17-2026 AG  Payload is packed in the queue object, not on the stack
+ *
+ *  License:
+ *		This file is copyright 2026 by agent (AG) and released under the Lesser GNU 
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+//*************************************************************************************
+
+#include "FreeRTOS.h"						// For critical sections
+#include "dlog.h"							// Header for this file
+
+
+//-------------------------------------------------------------------------------------
+/** This constructor creates a log queue and allocates its buffer.
+ *  @param a_size The number of bytes in the buffer; each record takes three bytes
+ *                plus the size of its arguments
+ */
+
+dlog_queue::dlog_queue (uint8_t a_size)
+{
+	buffer = new uint8_t[a_size];
+	size = a_size;
+	i_put = 0;
+	i_get = 0;
+	how_full = 0;
+	records_lost = 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method puts one record into the queue. It's normally called by the @c DLOG 
+ *  macros rather than directly. If there isn't room for the whole record, nothing is
+ *  put in and the record is counted as lost; the caller never has to wait. 
+ *  @param id The log statement's ID, its offset in the format table
+ *  @param p_args Pointer to the arguments' bytes
+ *  @param n_bytes The number of bytes of arguments
+ */
+
+void dlog_queue::put (uint16_t id, const uint8_t* p_args, uint8_t n_bytes)
+{
+	uint8_t record[DLOG_HEADER];
+
+	record[0] = n_bytes;
+	record[1] = (uint8_t)id;
+	record[2] = (uint8_t)(id >> 8);
+
+	portENTER_CRITICAL ();
+	if ((uint8_t)(size - how_full) < (uint8_t)(n_bytes + DLOG_HEADER))
+	{
+		records_lost++;
+	}
+	else
+	{
+		for (uint8_t index = 0; index < DLOG_HEADER + n_bytes; index++)
+		{
+			buffer[i_put] = (index < DLOG_HEADER) ? record[index] 
+												  : p_args[index - DLOG_HEADER];
+			if (++i_put >= size)
+			{
+				i_put = 0;
+			}
+		}
+		how_full += DLOG_HEADER + n_bytes;
+	}
+	portEXIT_CRITICAL ();
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method takes the records out of the queue and sends them through a telemetry
+ *  link. As many whole records as fit are packed into each frame, so the cost of a 
+ *  frame's header, CRC and zeros is shared among several records. Each record is 
+ *  copied out in its own critical section. Only one task may call this method. 
+ *  @param p_link The telemetry link through which the records are sent
+ *  @return The number of frames which were sent
+ */
+
+uint8_t dlog_queue::send (telemetry_link* p_link)
+{
+	uint8_t length;							// Number of bytes in the payload
+	uint8_t record;							// Number of bytes in the next record
+	uint8_t frames = 0;
+
+	do
+	{
+		length = 0;
+		portENTER_CRITICAL ();
+		while (how_full != 0)
+		{
+			record = buffer[i_get] + DLOG_HEADER;
+			if (length + record > TELEM_MAX_PAYLOAD)
+			{
+				break;
+			}
+			for (uint8_t count = record; count > 0; count--)
+			{
+				payload[length++] = buffer[i_get];
+				if (++i_get >= size)
+				{
+					i_get = 0;
+				}
+			}
+			how_full -= record;
+
+			// Let interrupts in between records
+			portEXIT_CRITICAL ();
+			portENTER_CRITICAL ();
+		}
+		portEXIT_CRITICAL ();
+
+		if (length != 0)
+		{
+			p_link->send (TELEM_LOG, payload, length);
+			frames++;
+		}
+	}
+	while (length != 0);
+
+	return (frames);
+}
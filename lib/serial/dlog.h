@@ -0,0 +1,281 @@
+//*************************************************************************************
+/** \file dlog.h
+ *    This file contains a deferred-format logging facility. A log statement doesn't 
+ *    turn numbers into text; it puts a two-byte ID and the raw bytes of its arguments
+ *    into a queue, and the format string stays behind in a table which is never loaded
+ *    into the AVR. The queue is emptied into a @c telemetry_link, and a program on the
+ *    PC uses the table to print the messages. 
+ *
+ *  Revised:
+ *    \li 10-17-2026 AG  Original file
+ *    \li 10-17-2026 AG  Payload is packed in the queue object, not on the stack
+ *
+ *  License:
+ *		This file is copyright 2026 by agent (AG) and released under the Lesser GNU 
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+//*************************************************************************************
+
+/// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _DLOG_H_
+#define _DLOG_H_
+
+#include <stdint.h>							// Standard size integer types
+#include <stddef.h>							// For size_t
+#include <string.h>							// For memcpy()
+#include "telemetry.h"						// Frames which carry the log records
+
+
+/// This is the largest number of arguments a log statement can have.
+const uint8_t DLOG_MAX_ARGS = 4;
+
+/// This is the largest number of bytes the arguments of one log statement can fill.
+const uint8_t DLOG_MAX_ARG_BYTES = 16;
+
+/** This is the number of bytes put into the queue with each record's arguments: a
+ *  length byte and the two byte ID.
+ */
+const uint8_t DLOG_HEADER = 3;
+
+
+/** \cond NO_DOXY These templates give each type of argument a one-letter code, the 
+ *  same letters used by Python's @c struct module, which is kept in the format table
+ *  so the PC knows how many bytes each argument has and how to read them. A type 
+ *  which has no code, such as a string or a pointer, can't be logged; trying gives an
+ *  error about an incomplete type. Enumerations must be cast to an integer type.
+ */
+template <size_t size, bool is_signed> struct dlog_int_code;
+template <> struct dlog_int_code<1, true>  { enum { code = 'b' }; };
+template <> struct dlog_int_code<1, false> { enum { code = 'B' }; };
+template <> struct dlog_int_code<2, true>  { enum { code = 'h' }; };
+template <> struct dlog_int_code<2, false> { enum { code = 'H' }; };
+template <> struct dlog_int_code<4, true>  { enum { code = 'i' }; };
+template <> struct dlog_int_code<4, false> { enum { code = 'I' }; };
+template <> struct dlog_int_code<8, true>  { enum { code = 'q' }; };
+template <> struct dlog_int_code<8, false> { enum { code = 'Q' }; };
+
+template <size_t size> struct dlog_float_code;
+template <> struct dlog_float_code<4> { enum { code = 'f' }; };
+template <> struct dlog_float_code<8> { enum { code = 'd' }; };
+
+template <class T> struct dlog_type;
+template <> struct dlog_type<bool> { enum { code = '?' }; };
+template <> struct dlog_type<char> { enum { code = 'c' }; };
+template <> struct dlog_type<signed char> : dlog_int_code<1, true> { };
+template <> struct dlog_type<unsigned char> : dlog_int_code<1, false> { };
+template <> struct dlog_type<short> : dlog_int_code<sizeof (short), true> { };
+template <> struct dlog_type<unsigned short> 
+	: dlog_int_code<sizeof (unsigned short), false> { };
+template <> struct dlog_type<int> : dlog_int_code<sizeof (int), true> { };
+template <> struct dlog_type<unsigned int> : dlog_int_code<sizeof (int), false> { };
+template <> struct dlog_type<long> : dlog_int_code<sizeof (long), true> { };
+template <> struct dlog_type<unsigned long> : dlog_int_code<sizeof (long), false> { };
+template <> struct dlog_type<long long> : dlog_int_code<sizeof (long long), true> { };
+template <> struct dlog_type<unsigned long long> 
+	: dlog_int_code<sizeof (long long), false> { };
+template <> struct dlog_type<float> : dlog_float_code<sizeof (float)> { };
+template <> struct dlog_type<double> : dlog_float_code<sizeof (double)> { };
+
+// This function is never defined; sizeof() of its result is an argument's type code
+template <class T> char (&dlog_code (const T&))[dlog_type<T>::code];
+
+/// This macro gives the one-letter code for the type of an expression, at compile time
+#define DLOG_CODE(x)  ((char)sizeof (dlog_code (x)))
+
+/// These macros turn the line number into part of a string constant
+#define DLOG_STR2(x)  #x
+#define DLOG_STR(x)   DLOG_STR2(x)
+
+/// This macro gives the file name and line number of a log statement as a string
+#define DLOG_WHERE    __FILE__ ":" DLOG_STR (__LINE__)
+
+/** This macro puts a variable into the format table's section. The section is marked
+ *  as not allocated, as debugging information is, so it takes no flash or RAM but its
+ *  contents are kept in the ELF file; the trailing comment character hides the flags
+ *  which the compiler adds after the section name. 
+ */
+#ifdef __AVR
+	#define DLOG_SECTION __attribute__ ((section (".dlog,\"\",@progbits;")))
+#else
+	#define DLOG_SECTION __attribute__ ((section (".dlog,\"\",@progbits#")))
+#endif
+
+/** This macro makes the format table entry for one log statement: the argument type 
+ *  codes in five bytes, then the file and line, then the format string. The entry's
+ *  address in the table is used as the log statement's ID. 
+ */
+#define DLOG_ENTRY(fmt, c1, c2, c3, c4) \
+	static const struct { char codes[DLOG_MAX_ARGS + 1]; \
+		char where[sizeof (DLOG_WHERE)]; char format[sizeof (fmt)]; } \
+		dlog_entry DLOG_SECTION = { { c1, c2, c3, c4, '\0' }, DLOG_WHERE, fmt }
+
+/// This macro gives the ID of the log statement whose entry was just made
+#define DLOG_ID  ((uint16_t)(size_t)&dlog_entry)
+
+/// This macro refuses to compile a log statement whose arguments are too big
+#define DLOG_CHECK(bytes) \
+	typedef char dlog_too_many_argument_bytes[((bytes) <= DLOG_MAX_ARG_BYTES) ? 1 : -1] \
+		__attribute__ ((unused))
+
+/** This function copies the bytes of one argument into a log record and moves the 
+ *  pointer past them.
+ */
+template <class T> 
+inline void dlog_pack (uint8_t*& p_to, const T& value)
+{
+	memcpy (p_to, &value, sizeof (T));
+	p_to += sizeof (T);
+}
+/// \endcond
+
+
+/** @brief This macro logs a message with no arguments.
+ *  @param p_log A pointer to the @c dlog_queue; nothing is logged if it's @c NULL
+ *  @param fmt A string constant with the message
+ */
+#define DLOG(p_log, fmt) \
+	do { if (p_log) { DLOG_ENTRY (fmt, 0, 0, 0, 0); \
+		(p_log)->put (DLOG_ID, NULL, 0); } } while (0)
+
+/** @brief This macro logs a message with one argument.
+ *  @param p_log A pointer to the @c dlog_queue; nothing is logged if it's @c NULL
+ *  @param fmt A @c printf() style format string constant
+ *  @param a The argument, which must have an integer, @c bool or floating point type
+ */
+#define DLOG1(p_log, fmt, a) \
+	do { if (p_log) { DLOG_ENTRY (fmt, DLOG_CODE (a), 0, 0, 0); \
+		DLOG_CHECK (sizeof (a)); \
+		uint8_t dlog_args[sizeof (a)]; \
+		uint8_t* p_dlog_arg = dlog_args; \
+		dlog_pack (p_dlog_arg, a); \
+		(p_log)->put (DLOG_ID, dlog_args, sizeof (dlog_args)); } } while (0)
+
+/** @brief This macro logs a message with two arguments.
+ *  @param p_log A pointer to the @c dlog_queue; nothing is logged if it's @c NULL
+ *  @param fmt A @c printf() style format string constant
+ *  @param a The first argument
+ *  @param b The second argument
+ */
+#define DLOG2(p_log, fmt, a, b) \
+	do { if (p_log) { DLOG_ENTRY (fmt, DLOG_CODE (a), DLOG_CODE (b), 0, 0); \
+		DLOG_CHECK (sizeof (a) + sizeof (b)); \
+		uint8_t dlog_args[sizeof (a) + sizeof (b)]; \
+		uint8_t* p_dlog_arg = dlog_args; \
+		dlog_pack (p_dlog_arg, a); \
+		dlog_pack (p_dlog_arg, b); \
+		(p_log)->put (DLOG_ID, dlog_args, sizeof (dlog_args)); } } while (0)
+
+/** @brief This macro logs a message with three arguments.
+ *  @param p_log A pointer to the @c dlog_queue; nothing is logged if it's @c NULL
+ *  @param fmt A @c printf() style format string constant
+ *  @param a The first argument
+ *  @param b The second argument
+ *  @param c The third argument
+ */
+#define DLOG3(p_log, fmt, a, b, c) \
+	do { if (p_log) { DLOG_ENTRY (fmt, DLOG_CODE (a), DLOG_CODE (b), DLOG_CODE (c), 0); \
+		DLOG_CHECK (sizeof (a) + sizeof (b) + sizeof (c)); \
+		uint8_t dlog_args[sizeof (a) + sizeof (b) + sizeof (c)]; \
+		uint8_t* p_dlog_arg = dlog_args; \
+		dlog_pack (p_dlog_arg, a); \
+		dlog_pack (p_dlog_arg, b); \
+		dlog_pack (p_dlog_arg, c); \
+		(p_log)->put (DLOG_ID, dlog_args, sizeof (dlog_args)); } } while (0)
+
+/** @brief This macro logs a message with four arguments.
+ *  @param p_log A pointer to the @c dlog_queue; nothing is logged if it's @c NULL
+ *  @param fmt A @c printf() style format string constant
+ *  @param a The first argument
+ *  @param b The second argument
+ *  @param c The third argument
+ *  @param d The fourth argument
+ */
+#define DLOG4(p_log, fmt, a, b, c, d) \
+	do { if (p_log) { DLOG_ENTRY (fmt, DLOG_CODE (a), DLOG_CODE (b), DLOG_CODE (c), \
+			DLOG_CODE (d)); \
+		DLOG_CHECK (sizeof (a) + sizeof (b) + sizeof (c) + sizeof (d)); \
+		uint8_t dlog_args[sizeof (a) + sizeof (b) + sizeof (c) + sizeof (d)]; \
+		uint8_t* p_dlog_arg = dlog_args; \
+		dlog_pack (p_dlog_arg, a); \
+		dlog_pack (p_dlog_arg, b); \
+		dlog_pack (p_dlog_arg, c); \
+		dlog_pack (p_dlog_arg, d); \
+		(p_log)->put (DLOG_ID, dlog_args, sizeof (dlog_args)); } } while (0)
+
+
+//-------------------------------------------------------------------------------------
+/** \brief This class holds deferred-format log records until they can be sent.
+ *  \details Each record is the number of argument bytes, the log statement's ID, and 
+ *  the arguments' raw bytes. A record is copied into the queue in one short critical
+ *  section, so any task may log; if there isn't room, the record is dropped and 
+ *  counted rather than making the task wait. One task, usually the one which sends 
+ *  telemetry, calls @c send() now and then to pack the waiting records into frames of
+ *  type @c TELEM_LOG.
+ * 
+ *  The format strings are kept in a section named @c .dlog which isn't loaded into 
+ *  the AVR. After linking, the table is copied out of the ELF file with 
+ *  \code
+ *  avr-objcopy -O binary -j .dlog --set-section-flags .dlog=alloc proj.elf proj.dlog
+ *  \endcode
+ *  and given to the program on the PC, which finds each ID's entry at that offset in 
+ *  the file. The table must be taken from the same build as the program which is 
+ *  running, as the IDs change whenever log statements are added or moved. 
+ * 
+ *  \section Usage
+ *  \code
+ *  dlog_queue* p_log = new dlog_queue (128);        // In main()
+ *  ...
+ *  DLOG2 (p_log, "speed %d, position %lu", speed, position);    // In any task
+ *  ...
+ *  p_log->send (p_telem_link);                      // In the telemetry task
+ *  \endcode
+ *  Arguments must be integers, @c bool, @c char or floating point numbers; the format
+ *  conversions are those of @c printf(), and the PC takes the arguments' sizes from 
+ *  their types rather than from the format, so \c \%d works for a @c long as well.
+ */
+
+class dlog_queue
+{
+	protected:
+		uint8_t* buffer;					///< Memory which holds the records
+		uint8_t size;						///< Number of bytes in the buffer
+		uint8_t i_put;						///< Where the next byte will be put
+		uint8_t i_get;						///< Where the next byte will be taken
+		uint8_t how_full;					///< Number of bytes in the buffer
+		uint16_t records_lost;				///< Number of records which didn't fit
+
+		/// Records are packed into a frame's payload here, rather than on the stack.
+		uint8_t payload[TELEM_MAX_PAYLOAD];
+
+	public:
+		// The constructor allocates the buffer
+		dlog_queue (uint8_t a_size);
+
+		// Put one record into the queue, or count it as lost if there isn't room
+		void put (uint16_t id, const uint8_t* p_args, uint8_t n_bytes);
+
+		// Send the records in the queue, packed into as few frames as possible
+		uint8_t send (telemetry_link* p_link);
+
+		/** This method returns the number of records which were dropped because the
+		 *  queue was full. 
+		 *  @return The number of records lost since this queue was created
+		 */
+		uint16_t get_records_lost (void)
+		{
+			return (records_lost);
+		}
+};
+
+#endif  // _DLOG_H_
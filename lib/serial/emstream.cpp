@@ -27,6 +27,10 @@
  *    \li 11-12-2012 JRR Made puts() non-virtual; made ENDL_STYLE() a function macro
  *    \li 12-21-2013 JRR Ported to ChibiOS
  *    \li 10-17-2014 JRR Made compatible with FreeRTOS for Cal Poly class use
+ *    \li 10-17-2026 AG  Added print_status() so devices can report error counts
+ *    \li 10-17-2026 AG  Added the fixed and scientific manipulators
+ *    \li 10-17-2026 AG  Added write(); puts() sends strings through it in blocks
+ *    \li 10-17-2026 AG  Added tx_room() for devices which may make a writer wait
  *
  *  License:
  *    This file released under the Lesser GNU Public License, version 2. This program
@@ -82,6 +86,7 @@ emstream::emstream (void)
 {
 	base = 10;                              // Numbers are shown as decimal by default
 	precision = 3;                          // Print 3 digits after a decimal point
+	print_fixed = false;                    // Print floats with exponents by default
 	#ifdef __AVR
 		pgm_string = false;                 // Print strings from SRAM by default
 	#endif
@@ -163,39 +168,98 @@ void emstream::clear_screen (void)
 }
 
 
+//-------------------------------------------------------------------------------------
+/** @brief   Print statistics about the device, such as counts of lost characters.
+ *  @details This is a base method which devices with buffers or error counters can
+ *           override to report how they are doing, for example in a status display. 
+ *           The base method prints nothing, because a simple device has nothing to 
+ *           report. 
+ *  @param   ser_dev A reference to the serial device on which to print the status
+ */
+
+void emstream::print_status (emstream& ser_dev)
+{
+	(void)ser_dev;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Find how many characters can be written without waiting.
+ *  @details Devices which make a writer wait when their transmit buffers are full 
+ *           override this method, so that text which may be thrown away can be 
+ *           dropped rather than waited on. The base method is for devices which never
+ *           wait, so it says that there's always room.
+ *  @return  The largest number of characters, as there's always room
+ */
+
+uint16_t emstream::tx_room (void)
+{
+	return (0xFFFF);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Write a block of characters to a serial device.
+ *  @details This base method writes a block of characters by calling \c putchar() 
+ *           for each one. Because \c putchar() is virtual, each character costs a 
+ *           call through the virtual table and whatever setup \c putchar() does, 
+ *           such as entering a critical section. Devices which can move a block of
+ *           characters into their buffers at once should override this method; the
+ *           string and number printing methods all send their text through it. 
+ *  @param   p_data A pointer to the characters to be written
+ *  @param   count The number of characters to be written
+ *  @return  The number of characters which were written
+ */
+
+uint16_t emstream::write (const char* p_data, uint16_t count)
+{
+	for (uint16_t left = count; left > 0; left--)
+	{
+		putchar (*p_data++);
+	}
+	return (count);
+}
+
+
 //-------------------------------------------------------------------------------------
 /** @brief   Write a character string to a serial device.
- *  @details This method writes a string to the serial device. It goes through the 
- *           character buffer to which its parameter points, calling \c putchar() to 
- *           print each character until and end of string character (the null 
- *           character, \c '\0') is reached.
+ *  @details This method writes a string to the serial device. A string in RAM is 
+ *           measured and given to \c write() all at once. A string in program memory
+ *           is copied a few characters at a time into a buffer on the stack, and 
+ *           each bufferful is given to \c write(). 
  *  @param   p_string A pointer to the string which is to be printed
  */
 
 void emstream::puts (const char* p_string)
 {
 #ifdef __AVR
-	char ch;                                // Temporary storage for a character
-
 	// If the program-string variable is set, this string is to be found in program
 	// memory rather than data memory
 	if (pgm_string)
 	{
+		char chunk[EMSTREAM_PGM_CHUNK];     // Characters copied from program memory
+		uint8_t count;                      // Number of characters in the chunk
+		char ch;                            // Temporary storage for a character
+
 		pgm_string = false;
-		while ((ch = pgm_read_byte_near (p_string++)))
+		do
 		{
-			putchar (ch);
+			count = 0;
+			while (count < EMSTREAM_PGM_CHUNK 
+				   && (ch = pgm_read_byte_near (p_string++)))
+			{
+				chunk[count++] = ch;
+			}
+			write (chunk, count);
 		}
+		while (count == EMSTREAM_PGM_CHUNK);
 	}
 	// If the program-string variable is not set, the string is in RAM and printed
 	// in the normal way
 	else
 #endif
 	{
-		while (*p_string)
-		{
-			putchar (*p_string++);
-		}
+		write (p_string, strlen (p_string));
 	}
 }
 
@@ -284,6 +348,12 @@ emstream& emstream::operator<< (ser_manipulator new_manip)
 		case (send_now):                    // Send whatever's in the send buffer
 			transmit_now ();
 			break;
+		case (fixed):                       // Print floats as 123.456
+			print_fixed = true;
+			break;
+		case (scientific):                  // Print floats as 1.235E+2
+			print_fixed = false;
+			break;
 		#ifdef __AVR
 			case (_p_str):                  // The next string is in program memory
 				pgm_string = true;
@@ -24,6 +24,11 @@
  *    \li 10-22-2012 JRR Fixed (OK, hacked around) bug which caused spurious warning 
  *                       for all Program Memory Strings
  *    \li 11-12-2012 JRR Made puts() non-virtual; made ENDL_STYLE() a function macro
+ *    \li 10-17-2026 AG  Added print_status() so devices can report error counts
+ *    \li 10-17-2026 AG  Integers converted to text without division or utoa()
+ *    \li 10-17-2026 AG  Added the 'fixed' and 'scientific' float formats
+ *    \li 10-17-2026 AG  Added virtual write() so text can be sent in blocks
+ *    \li 10-17-2026 AG  Added virtual tx_room() so callers can avoid waiting
  *
  *  License:
  *    This file released under the Lesser GNU Public License, version 2. This program
@@ -120,6 +125,14 @@ extern "C"
 	__c[] = s; &__c[0]; })
 
 
+/** @brief   The number of characters of a program memory string sent in each write.
+ *  @details Strings in program memory are copied into a buffer on the stack a few 
+ *           characters at a time so they can be given to @c write(). A bigger buffer
+ *           means fewer calls but uses more of the calling task's stack. 
+ */
+const uint8_t EMSTREAM_PGM_CHUNK = 16;
+
+
 /** \brief This macro simplifies the writing of code to conditionally print debugging 
  *  output. 
  *  \details
@@ -169,7 +182,8 @@ extern "C"
  *           base for the output stream from the default of base 10 (decimal) to and 
  *           from any base between 2 (binary), and 16 (hexadecimal), inclusive. The 
  *           precision for printing floating point numbers can be adjusted with
- *           @b setprecision(), which emits the @c manip_set_precision modifier.
+ *           @b setprecision(), which emits the @c manip_set_precision modifier, 
+ *           and @c fixed and @c scientific choose how floating point numbers look.
  *           Also defined are @c endl to send an end-of-line character, @c clrscr to
  *           send a clear-screen character which works with some terminal emulators 
  *           and not others, and @c send_now to tell some devices to transmit data as
@@ -196,6 +210,10 @@ typedef enum
 	clrscr,
 	/// If relevant to a device, tell it to send or save data immediately
 	send_now,
+	/// Print following floating point numbers with a decimal point, as in 123.456
+	fixed,
+	/// Print following floating point numbers with an exponent, as in 1.235E+2
+	scientific,
 	/// Set the precision (numbers after decimal) for printing floating point numbers
 	manip_set_precision,
 	/// Set the base for numerical printouts, from 2 (binary) to 16 (hexadecimal)
@@ -302,6 +320,32 @@ class emstream
 		 *  floating point number is being converted to text. */
 		char precision;
 
+		/** If this variable is true, floating point numbers are printed in fixed 
+		 *  point notation rather than with an exponent. */
+		bool print_fixed;
+
+		// Put the decimal digits of a 16-bit number from a power of ten in a buffer
+		static char* decimal_digits (uint16_t num, uint8_t index, bool started, 
+									 char* p_text);
+
+		// Put the decimal digits of a 32-bit unsigned number in a buffer
+		static char* decimal_text (uint32_t num, char* p_text);
+
+		// Write the decimal digits of a 16-bit number from a given power of ten
+		void put_decimal_digits (uint16_t num, uint8_t index, bool started);
+
+		// Write a 32-bit unsigned number in decimal without dividing
+		void put_decimal (uint32_t num);
+
+		// Write a float in fixed point notation if it's not too big to do so
+		bool put_fixed (float num);
+
+		// Write a signed number in decimal with a minus sign if needed
+		void put_signed_decimal (int32_t num);
+
+		// Write the bytes of a number in hexadecimal or binary, all digits shown
+		void put_bytes (const uint8_t* p_num, uint8_t size, bool in_binary);
+
 	// Public methods can be called from anywhere in the program where there is a 
 	// pointer or reference to an object of this class
 	public:
@@ -319,12 +363,19 @@ class emstream
 		 */
 		virtual void putchar (char a_char) = 0;
 
+		// Write a block of characters; descendents can override this to go faster
+		virtual uint16_t write (const char* p_data, uint16_t count);
+
+		// Find how many characters can be written without having to wait
+		virtual uint16_t tx_room (void);
+
 		void puts (const char*);            // Write a string to the serial device
 
 		virtual bool check_for_char (void); // Check if a character is in the buffer
 		virtual char getchar (void);        // Get a character; wait if none is ready
 		virtual void transmit_now (void);   // Immediately transmit any buffered data
 		virtual void clear_screen (void);   // Clear a display screen if there is one
+		virtual void print_status (emstream&);  // Show device statistics, if any
 
 		// This overloaded left-shift operator writes a boolean to the serial device
 		emstream& operator << (bool);
@@ -0,0 +1,222 @@
+//*************************************************************************************
+/** \file emstream_digits.cpp
+ *    This file contains the methods which turn integers into digits for the integer
+ *    operators of the \c emstream class. Decimal digits are found by subtracting 
+ *    powers of ten kept in flash rather than by dividing, which an AVR has to do in 
+ *    software; hexadecimal and binary digits are found by shifting and a table. 
+ *
+ *  Revised:
+ *    \li 10-17-2026 AG  Original file, replacing calls to utoa() and ultoa()
+ *    \li 10-17-2026 AG  Digits built in a buffer and sent with one write() call
+ *
+ *  License:
+ *    This file released under the Lesser GNU Public License, version 2. This program
+ *    is intended for educational use only, but it is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+#include "emstream.h"
+
+
+/// The powers of ten used to find the upper decimal digits of a 32-bit number.
+static const uint32_t PROGMEM powers_of_ten_32[] = 
+{
+	1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL, 10000UL
+};
+
+/// The powers of ten used to find the decimal digits of a 16-bit number.
+static const uint16_t PROGMEM powers_of_ten_16[] = 
+{
+	10000U, 1000U, 100U, 10U
+};
+
+/// The number of powers of ten in the 16-bit table.
+const uint8_t N_POWERS_16 = sizeof (powers_of_ten_16) / sizeof (uint16_t);
+
+/// The characters used for hexadecimal digits.
+static const char PROGMEM hex_digits[] = "0123456789ABCDEF";
+
+
+//-------------------------------------------------------------------------------------
+/** This method puts the decimal digits of a 16-bit number, starting with a given 
+ *  power of ten, into a buffer. Each digit is found by counting how many times its 
+ *  power of ten can be subtracted, which takes at most nine subtractions per digit. 
+ *  @param num The number to be converted, which must be less than ten times the 
+ *             first power of ten used
+ *  @param index The place in the power of ten table at which to start
+ *  @param started True if leading zeros are to be kept, false if they're not
+ *  @param p_text Pointer to the buffer, which must have room for five digits
+ *  @return A pointer to the place in the buffer just after the last digit
+ */
+
+char* emstream::decimal_digits (uint16_t num, uint8_t index, bool started, 
+								char* p_text)
+{
+	for ( ; index < N_POWERS_16; index++)
+	{
+		uint16_t power = pgm_read_word (&powers_of_ten_16[index]);
+		char digit = '0';
+
+		while (num >= power)
+		{
+			num -= power;
+			digit++;
+		}
+		if (started || digit != '0')
+		{
+			*p_text++ = digit;
+			started = true;
+		}
+	}
+	*p_text++ = (char)num + '0';
+
+	return (p_text);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method puts the decimal digits of a 32-bit unsigned number, without leading 
+ *  zeros, into a buffer. Digits down to the ten-thousands are found by subtracting 
+ *  32-bit powers of ten; what's left then fits in 16 bits, and the faster 16-bit 
+ *  subtractions are used. 
+ *  @param num The number to be converted
+ *  @param p_text Pointer to the buffer, which must have room for ten digits
+ *  @return A pointer to the place in the buffer just after the last digit
+ */
+
+char* emstream::decimal_text (uint32_t num, char* p_text)
+{
+	bool started = false;                   // True once a nonzero digit is found
+
+	if (num <= 0xFFFF)
+	{
+		return (decimal_digits ((uint16_t)num, 0, false, p_text));
+	}
+
+	for (uint8_t index = 0; index < sizeof (powers_of_ten_32) / sizeof (uint32_t); 
+		 index++)
+	{
+		uint32_t power = pgm_read_dword (&powers_of_ten_32[index]);
+		char digit = '0';
+
+		while (num >= power)
+		{
+			num -= power;
+			digit++;
+		}
+		if (started || digit != '0')
+		{
+			*p_text++ = digit;
+			started = true;
+		}
+	}
+
+	// The rest is less than 10000; start at the thousands and keep all the digits
+	return (decimal_digits ((uint16_t)num, 1, true, p_text));
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method writes the decimal digits of a 16-bit number, starting with a given 
+ *  power of ten. The digits are put in a buffer and sent with one call to 
+ *  \c write(). 
+ *  @param num The number to be written, which must be less than ten times the first 
+ *             power of ten used
+ *  @param index The place in the power of ten table at which to start
+ *  @param started True if leading zeros are to be printed, false if they're not
+ */
+
+void emstream::put_decimal_digits (uint16_t num, uint8_t index, bool started)
+{
+	char text[N_POWERS_16 + 1];             // Room for all the digits
+
+	write (text, decimal_digits (num, index, started, text) - text);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method writes a 32-bit unsigned number in decimal without leading zeros. 
+ *  @param num The number to be written
+ */
+
+void emstream::put_decimal (uint32_t num)
+{
+	char text[10];                          // Room for the digits of 4294967295
+
+	write (text, decimal_text (num, text) - text);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method writes a signed number in decimal, with a minus sign if it's negative.
+ *  @param num The number to be written
+ */
+
+void emstream::put_signed_decimal (int32_t num)
+{
+	char text[11];                          // Room for the digits and a minus sign
+	char* p_text = text;
+
+	if (num < 0)
+	{
+		*p_text++ = '-';
+		p_text = decimal_text ((uint32_t)0 - (uint32_t)num, p_text);
+	}
+	else
+	{
+		p_text = decimal_text ((uint32_t)num, p_text);
+	}
+	write (text, p_text - text);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method writes the bytes of a number in hexadecimal or binary, most significant
+ *  byte first, with all the digits of each byte, so that a 16-bit number always takes
+ *  four hexadecimal digits. Hexadecimal digits are looked up in a table in flash. The
+ *  digits of a hexadecimal number are all sent with one call to \c write(); binary 
+ *  digits are sent one byte's worth at a time. 
+ *  @param p_num Pointer to the number, which is in the AVR's little-endian order
+ *  @param size The number of bytes in the number, no more than eight
+ *  @param in_binary True to write binary digits, false for hexadecimal
+ */
+
+void emstream::put_bytes (const uint8_t* p_num, uint8_t size, bool in_binary)
+{
+	char text[16];                          // Digits of 8 bytes in hex or 1 in binary
+	char* p_text = text;
+
+	p_num += size;
+	while (size-- > 0)
+	{
+		uint8_t byte = *--p_num;
+
+		if (in_binary)
+		{
+			for (uint8_t bmask = 0x80; bmask != 0; bmask >>= 1)
+			{
+				*p_text++ = (byte & bmask) ? '1' : '0';
+			}
+			write (text, 8);
+			p_text = text;
+		}
+		else
+		{
+			*p_text++ = pgm_read_byte (&hex_digits[byte >> 4]);
+			*p_text++ = pgm_read_byte (&hex_digits[byte & 0x0F]);
+		}
+	}
+	if (p_text != text)
+	{
+		write (text, p_text - text);
+	}
+}
@@ -6,6 +6,8 @@
  *  Revised:
  *    \li 12-02-2012 JRR Split this file off from the main \c emstream.cpp to
  *                       allow smaller machine code if stuff in this file isn't used
+ *    \li 10-17-2026 AG  Added fixed point printing which doesn't use __ftoa_engine
+ *    \li 10-17-2026 AG  Numbers built in a buffer and sent with write()
  *
  *  License:
  *    This file released under the Lesser GNU Public License, version 2. This program
@@ -30,11 +32,113 @@
 #include "emstream.h"
 
 
+/** This is the largest size of a number which is printed in fixed point notation. 
+ *  Larger numbers, infinities and NaN's are printed with an exponent, as the integer
+ *  part of the number has to fit in 32 bits. 
+ */
+const float FIXED_LIMIT = 4.0e9;
+
+/** This is the number of bits after the binary point in the fixed point fraction 
+ *  used while printing in fixed point notation. Multiplying such a fraction by ten
+ *  puts the next decimal digit in the top four bits of a 32-bit number.
+ */
+const uint8_t FRACTION_BITS = 28;
+
+/// The powers of ten by which the bits below the fixed point fraction are scaled.
+static const float PROGMEM fraction_scales[] = 
+{
+	1.0, 10.0, 100.0, 1000.0, 10000.0, 100000.0, 1000000.0, 10000000.0
+};
+
+
+//-------------------------------------------------------------------------------------
+/** This method writes a floating point number in fixed point notation, as in 
+ *  "-123.456", with @c precision digits after the decimal point. Rather than using 
+ *  @c __ftoa_engine(), it splits the number into a 32-bit integer part, which is 
+ *  printed as an integer, and a fixed point fraction whose digits are found by 
+ *  multiplying by ten, so it's much faster. The last digit is rounded, with halves 
+ *  rounded up. Numbers too large for the integer part to fit in 32 bits aren't 
+ *  printed. The text is built in a buffer and sent with one call to @c write(). 
+ *  @param num The number to be written
+ *  @return True if the number was printed, false if it's too large or isn't a number
+ */
+
+bool emstream::put_fixed (float num)
+{
+	uint8_t digits = (precision > 7) ? 7 : precision;
+
+	// The comparisons are false for NaN, so it is left for __ftoa_engine() too
+	if (!(num < FIXED_LIMIT && num > -FIXED_LIMIT))
+	{
+		return (false);
+	}
+	char text[20];                          // Sign, 10 digits, point, 7 digits
+	char* p_text = text;
+	if (num < 0.0)
+	{
+		*p_text++ = '-';
+		num = -num;
+	}
+
+	// Take off the integer part; scaling the rest by a power of two is exact. Bits of
+	// small numbers which fall below the fixed point fraction are kept in a float
+	uint32_t whole = (uint32_t)num;
+	float scaled = (num - (float)whole) * (float)(1UL << FRACTION_BITS);
+	uint32_t fraction = (uint32_t)scaled;
+	float below = scaled - (float)fraction;
+
+	// Each multiplication by ten moves the next digit above the binary point
+	char fraction_digits[8];
+	for (uint8_t index = 0; index < digits; index++)
+	{
+		fraction *= 10;
+		fraction_digits[index] = (char)(fraction >> FRACTION_BITS) + '0';
+		fraction &= (1UL << FRACTION_BITS) - 1;
+	}
+
+	// If what's left is half a digit or more, round up, carrying as far as needed
+	if (below != 0.0)
+	{
+		fraction += (uint32_t)(below * pgm_read_float (&fraction_scales[digits]));
+	}
+	if (fraction >= (1UL << (FRACTION_BITS - 1)))
+	{
+		uint8_t index = digits;
+		while (index > 0 && fraction_digits[index - 1] == '9')
+		{
+			fraction_digits[--index] = '0';
+		}
+		if (index > 0)
+		{
+			fraction_digits[index - 1]++;
+		}
+		else
+		{
+			whole++;
+		}
+	}
+
+	p_text = decimal_text (whole, p_text);
+	if (digits != 0)
+	{
+		*p_text++ = '.';
+		for (uint8_t index = 0; index < digits; index++)
+		{
+			*p_text++ = fraction_digits[index];
+		}
+	}
+	write (text, p_text - text);
+	return (true);
+}
+
+
 //-------------------------------------------------------------------------------------
 /** This operator writes a single-precision floating point number to the serial port in
  *  exponential format (always with the 'e' notation). It calls the utility function 
  *  __ftoa_engine, which is hiding in the AVR libraries, used by the Xprintf() 
  *  functions when they need to convert a float into text. 
+ *  If the @c fixed manipulator has been used, the number is written in fixed point
+ *  notation instead, unless it's too large or isn't a number. 
  *  @return A reference to the serial device to which the data was printed. This
  *          reference is used to string printable items together with "<<" operators
  *  @param num The floating point number to be sent out
@@ -46,6 +150,11 @@ emstream& emstream::operator<< (float num)
 	char buf[20];
 	char* p_buf = buf;
 
+	if (print_fixed && put_fixed (num))
+	{
+		return (*this);
+	}
+
 	int exponent = __ftoa_engine ((double)num, buf, digit, 16);
 	uint8_t vtype = *p_buf++;
 	if (vtype & FTOA_NAN)
@@ -54,29 +163,34 @@ emstream& emstream::operator<< (float num)
 		return (*this);
 	}
 
+	// The sign, mantissa and start of the exponent are sent with one write()
+	char text[16];
+	char* p_text = text;
+
 	// Display the sign if it's negative
 	if (vtype & FTOA_MINUS)
 	{
-		putchar ('-');
+		*p_text++ = '-';
 	}
 
 	// Show the mantissa
-	putchar (*p_buf++);
+	*p_text++ = *p_buf++;
 	if (digit)
 	{
-		putchar ('.');
+		*p_text++ = '.';
 	}
 	while ((digit-- > 0) && *p_buf)
 	{
-		putchar (*p_buf++);
+		*p_text++ = *p_buf++;
 	}
 
 	// Now display the exponent
-	putchar ('E');
+	*p_text++ = 'E';
 	if (exponent > 0)
 	{
-		putchar ('+');
+		*p_text++ = '+';
 	}
+	write (text, p_text - text);
 	*this << exponent;
 	return (*this);
 }
@@ -87,6 +201,8 @@ emstream& emstream::operator<< (float num)
  *  exponential format (always with the 'e' notation). It calls the utility function 
  *  @c __ftoa_engine(), which is hiding in the AVR libraries, used by the @c Xprintf() 
  *  functions when they need to convert a double into text. 
+ *  If the @c fixed manipulator has been used, the number is written in fixed point
+ *  notation instead; on an AVR a double is the same as a float, so nothing is lost. 
  *  @return A reference to the serial device to which the data was printed. This
  *          reference is used to string printable items together with "<<" operators
  *  @param num The double-precision floating point number to be sent out
@@ -98,6 +214,11 @@ emstream& emstream::operator<< (double num)
 	char buf[20];
 	char* p_buf = buf;
 
+	if (print_fixed && put_fixed ((float)num))
+	{
+		return (*this);
+	}
+
 	int exponent = __ftoa_engine (num, buf, digit, 16);
 	uint8_t vtype = *p_buf++;
 	if (vtype & FTOA_NAN)
@@ -106,22 +227,26 @@ emstream& emstream::operator<< (double num)
 		return (*this);
 	}
 
+	// The sign, mantissa and start of the exponent are sent with one write()
+	char text[16];
+	char* p_text = text;
+
 	// Display the sign if it's negative
 	if (vtype & FTOA_MINUS)
-		putchar ('-');
+		*p_text++ = '-';
 
 	// Show the mantissa
-	putchar (*p_buf++);
+	*p_text++ = *p_buf++;
 	if (digit)
-		putchar ('.');
-	do
-		putchar (*p_buf++);
-	while (--digit && *p_buf);
+		*p_text++ = '.';
+	while ((digit-- > 0) && *p_buf)
+		*p_text++ = *p_buf++;
 
 	// Now display the exponent
-	putchar ('e');
+	*p_text++ = 'e';
 	if (exponent > 0)
-		putchar ('+');
+		*p_text++ = '+';
+	write (text, p_text - text);
 	*this << exponent;
 	return (*this);
 }
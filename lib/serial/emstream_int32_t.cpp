@@ -6,6 +6,7 @@
  *  Revised:
  *    \li 12-02-2012 JRR Split this file off from the main \c emstream.cpp to
  *                       allow smaller machine code if stuff in this file isn't used
+ *    \li 10-17-2026 AG  Decimal digits found by put_signed_decimal()
  *
  *  License:
  *    This file released under the Lesser GNU Public License, version 2. This program
@@ -25,7 +26,6 @@
  *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
 //*************************************************************************************
 
-#include <stdlib.h>
 #include "emstream.h"
 
 
@@ -45,9 +45,7 @@ emstream& emstream::operator<< (int32_t num)
 	}
 	else
 	{
-		char out_str[34];
-		ltoa ((long)num, out_str, base);
-		puts (out_str);
+		put_signed_decimal (num);
 	}
 
 	return (*this);
@@ -6,6 +6,7 @@
  *  Revised:
  *    \li 12-02-2012 JRR Split this file off from the main \c emstream.cpp to
  *                       allow smaller machine code if stuff in this file isn't used
+ *    \li 10-17-2026 AG  Digits found by put_decimal_digits() and put_bytes()
  *
  *  License:
  *    This file released under the Lesser GNU Public License, version 2. This program
@@ -39,15 +40,13 @@
 
 emstream& emstream::operator<< (uint16_t num)
 {
-	if (base == 16 || base == 8 || base == 2)
+	if (base == 16 || base == 2)
 	{
-		union
-		{
-			uint16_t whole;
-			uint8_t bits[2];
-		} parts;
-		parts.whole = num;
-		*this << parts.bits[1] << parts.bits[0];
+		put_bytes ((const uint8_t*)&num, sizeof (num), base == 2);
+	}
+	else if (base == 10)
+	{
+		put_decimal_digits (num, 0, false);
 	}
 	else
 	{
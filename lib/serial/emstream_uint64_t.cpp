@@ -6,6 +6,8 @@
  *  Revised:
  *    \li 12-02-2012 JRR Split this file off from the main \c emstream.cpp to
  *                       allow smaller machine code if stuff in this file isn't used
+ *    \li 10-17-2026 AG  Digits found by put_bytes(); binary is written too
+ *    \li 10-17-2026 AG  Decimal is written too, found without 64-bit division
  *
  *  License:
  *    This file released under the Lesser GNU Public License, version 2. This program
@@ -25,14 +27,30 @@
  *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
 //*************************************************************************************
 
-#include <stdlib.h>
 #include "emstream.h"
 
 
+/** The powers of ten used to find the decimal digits of a 64-bit number down to the
+ *  ten-thousands, from 10^19, the largest which fits in 64 bits, down to 10^4.
+ */
+static const uint64_t PROGMEM powers_of_ten_64[] = 
+{
+	10000000000000000000ULL, 1000000000000000000ULL, 100000000000000000ULL, 
+	10000000000000000ULL, 1000000000000000ULL, 100000000000000ULL, 10000000000000ULL,
+	1000000000000ULL, 100000000000ULL, 10000000000ULL, 1000000000ULL, 100000000ULL,
+	10000000ULL, 1000000ULL, 100000ULL, 10000ULL
+};
+
+
 //-------------------------------------------------------------------------------------
 /** This operator writes a long long (64-bit) unsigned integer to the serial port as a 
- *  text string.  It only writes such numbers in unsigned hexadecimal format. The
- *  number is written by breaking it into two unsigned longs, writing them in order.
+ *  text string. It writes such numbers in decimal if the \c dec manipulator has been
+ *  used and in binary if \c bin has been used; with any other base, including 
+ *  \c oct, it writes unsigned hexadecimal. Hexadecimal and binary numbers show all 
+ *  the digits. A number which fits in 32 bits is written by \c put_decimal(); for a
+ *  larger one, each digit down to the ten-thousands is found by subtracting 64-bit 
+ *  powers of ten, and the last four digits by \c decimal_digits(), so the slow 64-bit
+ *  division in libgcc isn't needed. 
  *  @return A reference to the serial device to which the data was printed. This
  *          reference is used to string printable items together with "<<" operators
  *  @param num The 64-bit number to be sent out
@@ -40,14 +58,43 @@
 
 emstream& emstream::operator<< (uint64_t num)
 {
-	union {
-		   uint64_t whole;
-		   uint8_t bits[8];
-		  } parts;
-	parts.whole = num;
-	*this << parts.bits[7] << parts.bits[6] << parts.bits[5] << parts.bits[4]
-		  << parts.bits[3] << parts.bits[2] << parts.bits[1] << parts.bits[0];
+	if (base != 10)
+	{
+		put_bytes ((const uint8_t*)&num, sizeof (num), base == 2);
+	}
+	else if (num <= 0xFFFFFFFFUL)
+	{
+		put_decimal ((uint32_t)num);
+	}
+	else
+	{
+		char text[20];                      // Room for 18446744073709551615
+		char* p_text = text;
+		bool started = false;               // True once a nonzero digit is found
+		uint64_t power;
+
+		for (uint8_t index = 0; index < sizeof (powers_of_ten_64) / sizeof (uint64_t);
+			 index++)
+		{
+			memcpy_P (&power, &powers_of_ten_64[index], sizeof (power));
+			char digit = '0';
+
+			while (num >= power)
+			{
+				num -= power;
+				digit++;
+			}
+			if (started || digit != '0')
+			{
+				*p_text++ = digit;
+				started = true;
+			}
+		}
+
+		// The rest is less than 10000; start at the thousands and keep all the digits
+		p_text = decimal_digits ((uint16_t)num, 1, true, p_text);
+		write (text, p_text - text);
+	}
 
 	return (*this);
 }
-
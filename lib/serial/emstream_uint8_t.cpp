@@ -6,6 +6,7 @@
  *  Revised:
  *    \li 12-02-2012 JRR Split this file off from the main \c emstream.cpp to
  *                       allow smaller machine code if stuff in this file isn't used
+ *    \li 10-17-2026 AG  Digits found by put_decimal_digits() and put_bytes()
  *
  *  License:
  *    This file released under the Lesser GNU Public License, version 2. This program
@@ -41,26 +42,17 @@
 
 emstream& emstream::operator<< (uint8_t num)
 {
-	uint8_t temp_char;                      // Temporary storage for a nibble
-
 	if (print_ascii)
 	{
 		putchar (num);
 	}
-	else if (base == 2)
+	else if (base == 16 || base == 2)
 	{
-		for (uint8_t bmask = 0x80; bmask != 0; bmask >>= 1)
-		{
-			if (num & bmask) putchar ('1');
-			else             putchar ('0');
-		}
+		put_bytes (&num, 1, base == 2);
 	}
-	else if (base == 16)
+	else if (base == 10)
 	{
-		temp_char = (num >> 4) & 0x0F;
-		putchar ((temp_char > 9) ? temp_char + ('A' - 10) : temp_char + '0');
-		temp_char = num & 0x0F;
-		putchar ((temp_char > 9) ? temp_char + ('A' - 10) : temp_char + '0');
+		put_decimal_digits (num, 2, false);
 	}
 	else
 	{
@@ -23,6 +23,12 @@
  *    \li 07-05-2008 JRR Changed from 1 to 2 stop bits to placate finicky receivers
  *    \li 12-22-2008 JRR Split off stuff in base232.h for efficiency
  *    \li 06-30-2009 JRR Received data interrupt and buffer added
+ *    \li 10-17-2026 AG  Transmitter interrupt and per-port transmit ring buffers
+ *    \li 10-17-2026 AG  Per-port receive buffers with error counts and task wakeups
+ *    \li 10-17-2026 AG  Baud rates up to 1M; baud rate is 32 bits
+ *    \li 10-17-2026 AG  Added write() which fills the transmit buffer in blocks
+ *    \li 10-17-2026 AG  putchar() doesn't poll when the scheduler is only suspended
+ *    \li 10-17-2026 AG  write() doesn't poll when the scheduler is only suspended
  *
  *  License:
  *		This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -44,28 +50,41 @@
 #include <stdlib.h>
 #include <avr/io.h>
 #include "rs232int.h"
+#include "task.h"							// For vTaskDelay() and scheduler state
+#include "taskbase.h"						// For waking tasks which wait for input
 
 
-// Every AVR has at least one serial port, so enable at least one receiver buffer
-/// This buffer holds characters received through serial port 0 by the ISR. 
-uint8_t* rcv0_buffer = NULL;
+// Buffer indices are 8-bit and wrap with a mask, so buffer sizes are restricted
+#if (RSINT_RX_BUF_SIZE_0 & (RSINT_RX_BUF_SIZE_0 - 1)) || (RSINT_RX_BUF_SIZE_0 > 128)
+	#error RSINT_RX_BUF_SIZE_0 must be a power of two no larger than 128
+#endif
+#if (RSINT_RX_BUF_SIZE_1 & (RSINT_RX_BUF_SIZE_1 - 1)) || (RSINT_RX_BUF_SIZE_1 > 128)
+	#error RSINT_RX_BUF_SIZE_1 must be a power of two no larger than 128
+#endif
+#if (RSINT_TX_BUF_SIZE_0 & (RSINT_TX_BUF_SIZE_0 - 1)) || (RSINT_TX_BUF_SIZE_0 > 128)
+	#error RSINT_TX_BUF_SIZE_0 must be a power of two no larger than 128
+#endif
+#if (RSINT_TX_BUF_SIZE_1 & (RSINT_TX_BUF_SIZE_1 - 1)) || (RSINT_TX_BUF_SIZE_1 > 128)
+	#error RSINT_TX_BUF_SIZE_1 must be a power of two no larger than 128
+#endif
 
-/// This index is used to write into serial character receiver buffer 0.
-uint16_t rcv0_read_index;
 
-/// This index is used to read from serial character receiver buffer 0. 
-uint16_t rcv0_write_index;
+// Every AVR has at least one serial port, so enable at least one receiver buffer
+/// This buffer holds characters received through serial port 0 by the ISR. 
+rsint_rx_buffer rx_buf_0 = {{NULL, 0, 0, 0}, 0, 0, NULL};
 
-// If there's a UCSR0A register, there are 2 serial ports, so enable another buffer
+// If there's a UCSR1A register, there are 2 serial ports, so enable another buffer
 #ifdef UCSR1A
 	/// This buffer holds characters received through serial port 1 by the ISR. 
-	uint8_t* rcv1_buffer = NULL;
+	rsint_rx_buffer rx_buf_1 = {{NULL, 0, 0, 0}, 0, 0, NULL};
+#endif
 
-	/// This index is used to write into serial character receiver buffer 1.
-	uint16_t rcv1_read_index;
+/// This buffer holds characters waiting to be sent through serial port 0 by the ISR.
+rsint_ring tx_ring_0 = {NULL, 0, 0, 0};
 
-	/// This index is used to read from serial character receiver buffer 1. 
-	uint16_t rcv1_write_index;
+#ifdef UCSR1A
+	/// This buffer holds characters waiting to be sent through serial port 1.
+	rsint_ring tx_ring_1 = {NULL, 0, 0, 0};
 #endif
 
 
@@ -82,44 +101,64 @@ uint16_t rcv0_write_index;
  *                     1 only exists on some processors). The default is port 0 
  */
 
-rs232::rs232 (uint16_t baud_rate, uint8_t port_number)
+rs232::rs232 (uint32_t baud_rate, uint8_t port_number)
 	: emstream (), base232 (baud_rate, port_number)
 {
 	// Save the number of the serial port, 0 or 1
 	port_num = port_number;
 
+	// Start out with the default transmit timeout and no transmission troubles
+	tx_timeout = RSINT_TX_TIMEOUT;
+	tx_blocked = 0;
+	tx_dropped = 0;
+
 	// If we're compiling for a chip with UCSR0A defined, it has dual serial ports
 	// (examples are ATmega324P and ATmega128). Set up Port 0 or Port 1
 	#if defined UCSR0A // Serial port number 0
 		if (port_number == 0)
 		{
+			// Allocate memory for the receiver buffer before its interrupt is enabled
+			rx_buf_0.ring.buffer = new uint8_t[RSINT_RX_BUF_SIZE_0];
+			rx_buf_0.ring.mask = RSINT_RX_BUF_SIZE_0 - 1;
+			p_rx = &rx_buf_0;
 			UCSR0B |= (1 << RXCIE0);		// Receive complete interrupt enable
 
-			// Allocate some memory for the receiver buffer and reset the indices
-			rcv0_buffer = new uint8_t[RSINT_BUF_SIZE];
-			rcv0_read_index = 0;
-			rcv0_write_index = 0;
+			// The transmit buffer is filled by putchar() and emptied by the ISR
+			tx_ring_0.buffer = new uint8_t[RSINT_TX_BUF_SIZE_0];
+			tx_ring_0.mask = RSINT_TX_BUF_SIZE_0 - 1;
+			p_tx_ring = &tx_ring_0;
+			mask_UDRIE = (1 << UDRIE0);
 		}
 		else  // Serial port number 1
 		{
 		#if defined UCSR1A
+			// Allocate memory for the receiver buffer before its interrupt is enabled
+			rx_buf_1.ring.buffer = new uint8_t[RSINT_RX_BUF_SIZE_1];
+			rx_buf_1.ring.mask = RSINT_RX_BUF_SIZE_1 - 1;
+			p_rx = &rx_buf_1;
 			UCSR1B |= (1 << RXCIE1);		// Receive complete interrupt enable
 
-			// Allocate some memory for the receiver buffer and reset the indices
-			rcv1_buffer = new uint8_t[RSINT_BUF_SIZE];
-			rcv1_read_index = 0;
-			rcv1_write_index = 0;
+			// The transmit buffer is filled by putchar() and emptied by the ISR
+			tx_ring_1.buffer = new uint8_t[RSINT_TX_BUF_SIZE_1];
+			tx_ring_1.mask = RSINT_TX_BUF_SIZE_1 - 1;
+			p_tx_ring = &tx_ring_1;
+			mask_UDRIE = (1 << UDRIE1);
 		#endif // UCSR1A
 		}
 	// We're compiling for a chip which doesn't define UCSR0A; assume it has only one
 	// serial port.
 	#else
+		// Allocate memory for the receiver buffer before its interrupt is enabled
+		rx_buf_0.ring.buffer = new uint8_t[RSINT_RX_BUF_SIZE_0];
+		rx_buf_0.ring.mask = RSINT_RX_BUF_SIZE_0 - 1;
+		p_rx = &rx_buf_0;
 		UCSRB |= (1 << RXCIE);				// Receive complete interrupt enable
 
-		// Allocate some memory for the receiver buffer and reset the indices
-		rcv0_buffer = new uint8_t[RSINT_BUF_SIZE];
-		rcv0_read_index = 0;
-		rcv0_write_index = 0;
+		// The transmit buffer is filled by putchar() and emptied by the ISR
+		tx_ring_0.buffer = new uint8_t[RSINT_TX_BUF_SIZE_0];
+		tx_ring_0.mask = RSINT_TX_BUF_SIZE_0 - 1;
+		p_tx_ring = &tx_ring_0;
+		mask_UDRIE = (1 << UDRIE);
 	#endif
 
 	// The Xiphos 1.0 board may need the pullup activated on the RXD1 line in order to
@@ -132,36 +171,204 @@ rs232::rs232 (uint16_t baud_rate, uint8_t port_number)
 
 
 //-------------------------------------------------------------------------------------
-/** This method sends one character to the serial port.  It waits until the port is
- *  ready, so it can hold up the system for a while.  It times out if it waits too 
- *  long to send the character; you can check the return value to see if the character
- *  was successfully sent, or just cross your fingers and ignore the return value.
- *  Note 1:  It's possible that at slower baud rates and/or higher processor speeds, 
- *  this routine might time out even when the port is working fine.  A solution would
- *  be to change the count variable to an integer and use a larger starting number. 
- *  Note 2:  Fixed!  The count is now an integer and it works at lower baud rates.
+/** This method sends one character to the serial port. Normally the character is put
+ *  into the transmit buffer and the transmitter interrupt is enabled; the ISR sends
+ *  the character when the UART is ready, so the calling task doesn't have to wait for
+ *  the bits to go out. If the buffer is full, this method waits in steps of one RTOS
+ *  tick, letting other tasks run, for up to \c tx_timeout ticks; if there's still no
+ *  room the character is dropped and counted. If interrupts are disabled or the RTOS 
+ *  scheduler hasn't been started, the ISR can't be relied upon to empty the buffer, 
+ *  so the buffer's contents and the new character are sent by polling the UART. If 
+ *  the scheduler has only been suspended, the ISR still empties the buffer, so the 
+ *  character is buffered as usual; but a task can't be delayed while the scheduler is
+ *  suspended, so if there's no room the character is dropped and counted at once. 
  *  @param chout The character to be sent out
- *  @return True if everything was OK and false if there was a timeout
  */
 
 void rs232::putchar (char chout)
 {
-	// Now wait for the serial port transmitter buffer to be empty	 
-	for (uint16_t count = 0; ((*p_USR & mask_UDRE) == 0); count++)
+	uint8_t old_sreg = SREG;				// Interrupt state, saved for restoring
+	BaseType_t state = xTaskGetSchedulerState ();
+
+	// If interrupts are off (in main() before the scheduler starts, in a critical 
+	// section or in an ISR) or the scheduler hasn't started, send the old-fashioned way
+	if (!(old_sreg & (1 << SREG_I)) || state == taskSCHEDULER_NOT_STARTED)
+	{
+		cli ();
+		send_polled (chout);
+		SREG = old_sreg;
+		return;
+	}
+
+	for (TickType_t waited = 0; ; waited++)
 	{
-		if (count > UART_TX_TOUT)
+		// Check for room and put the character in with interrupts off, so that other
+		// tasks writing to this port can't grab the same spot in the buffer
+		cli ();
+		if ((uint8_t)(p_tx_ring->i_put - p_tx_ring->i_get) <= p_tx_ring->mask)
+		{
+			p_tx_ring->buffer[p_tx_ring->i_put & p_tx_ring->mask] = chout;
+			p_tx_ring->i_put++;
+			*p_UCR |= mask_UDRIE;
+			SREG = old_sreg;
+			return;
+		}
+		SREG = old_sreg;
+
+		// The buffer is full. Give up if we've waited long enough or aren't allowed
+		// to wait at all; otherwise let other tasks run while the ISR makes room
+		if (waited >= tx_timeout || state == taskSCHEDULER_SUSPENDED)
 		{
+			tx_dropped++;
 			return;
 		}
+		if (waited == 0)
+		{
+			tx_blocked++;
+		}
+		vTaskDelay (1);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method sends a block of characters to the serial port. It works as 
+ *  \c putchar() does, but it copies up to \c RSINT_TX_CHUNK characters into the 
+ *  transmit buffer in each critical section, so printing a line of text takes a few
+ *  critical sections rather than one for each character. If the buffer is full, it 
+ *  waits for room in steps of one RTOS tick; if no room appears within \c tx_timeout 
+ *  ticks, the characters which haven't been sent are dropped and counted. As in 
+ *  \c putchar(), characters are sent by polling only if interrupts are off or the
+ *  scheduler hasn't started; while the scheduler is suspended, what doesn't fit in 
+ *  the buffer is dropped and counted rather than waited for. 
+ *  @param p_data A pointer to the characters to be sent
+ *  @param count The number of characters to be sent
+ *  @return The number of characters which were put in the buffer or sent
+ */
+
+uint16_t rs232::write (const char* p_data, uint16_t count)
+{
+	uint8_t old_sreg = SREG;				// Interrupt state, saved for restoring
+	uint16_t done = 0;						// Number of characters sent so far
+	BaseType_t state = xTaskGetSchedulerState ();
+
+	// If the ISR can't be relied upon to empty the buffer, send by polling
+	if (!(old_sreg & (1 << SREG_I)) || state == taskSCHEDULER_NOT_STARTED)
+	{
+		cli ();
+		while (done < count)
+		{
+			send_polled (p_data[done++]);
+		}
+		SREG = old_sreg;
+		return (done);
 	}
 
-	// Clear the TXCn bit so it can be used to check if the serial port is busy.  This
-	// check needs to be done prior to putting the processor into sleep mode.  Oddly,
-	// the TXCn bit is cleared by writing a one to its bit location
-	*p_USR |= mask_TXC;
+	TickType_t waited = 0;					// Ticks spent waiting for room
+	while (done < count)
+	{
+		uint8_t chunk = RSINT_TX_CHUNK;		// Characters to copy this time
+		if (count - done < chunk)
+		{
+			chunk = (uint8_t)(count - done);
+		}
 
-	// The CTS line is 0 and the transmitter buffer is empty, so send the character
-	*p_UDR = chout;
+		// Copy as much as fits with interrupts off, so that other tasks writing to
+		// this port can't grab the same spots in the buffer. The room is found by
+		// name rather than through the virtual table, so the check is inlined
+		cli ();
+		uint8_t room = rs232::tx_room ();
+		if (chunk > room)
+		{
+			chunk = room;
+		}
+		if (chunk > 0)
+		{
+			uint8_t i_put = p_tx_ring->i_put;
+			done += chunk;
+			while (chunk-- > 0)
+			{
+				p_tx_ring->buffer[i_put++ & p_tx_ring->mask] = *p_data++;
+			}
+			p_tx_ring->i_put = i_put;
+			*p_UCR |= mask_UDRIE;
+			SREG = old_sreg;
+			waited = 0;
+			continue;
+		}
+		SREG = old_sreg;
+
+		// The buffer is full. Give up if we've waited long enough or aren't allowed
+		// to wait at all; otherwise let other tasks run while the ISR makes room
+		if (waited >= tx_timeout || state == taskSCHEDULER_SUSPENDED)
+		{
+			tx_dropped += count - done;
+			return (done);
+		}
+		if (waited == 0)
+		{
+			tx_blocked++;
+		}
+		vTaskDelay (1);
+		waited++;
+	}
+	return (done);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method sends whatever is in the transmit buffer, followed by the given 
+ *  character, by polling the UART. It must only be called with interrupts disabled so
+ *  that the transmitter ISR doesn't take characters from the buffer at the same time.
+ *  Each character waits for the UART to be ready, timing out as the original polled
+ *  version of \c putchar() did if the port doesn't become ready. 
+ *  @param chout The character to be sent after the buffer's contents
+ */
+
+void rs232::send_polled (char chout)
+{
+	bool last;								// True when sending the new character
+	char next_char;							// The character being sent now
+
+	do
+	{
+		// Characters already in the buffer must go out before the new one
+		last = (p_tx_ring->i_get == p_tx_ring->i_put);
+		if (last)
+		{
+			next_char = chout;
+		}
+		else
+		{
+			next_char = p_tx_ring->buffer[p_tx_ring->i_get & p_tx_ring->mask];
+		}
+
+		// Now wait for the serial port transmitter buffer to be empty	 
+		for (uint16_t count = 0; ((*p_USR & mask_UDRE) == 0); count++)
+		{
+			if (count > UART_TX_TOUT)
+			{
+				return;
+			}
+		}
+
+		// Clear the TXCn bit so it can be used to check if the serial port is busy.
+		// This check needs to be done prior to putting the processor into sleep mode.
+		// Oddly, the TXCn bit is cleared by writing a one to its bit location
+		*p_USR |= mask_TXC;
+
+		// The transmitter buffer is empty, so send the character
+		*p_UDR = next_char;
+
+		if (!last)
+		{
+			p_tx_ring->i_get++;
+		}
+	}
+	while (!last);
+
+	// The buffer has been emptied, so the ISR has nothing to do
+	*p_UCR &= ~mask_UDRIE;
 }
 
 
@@ -169,38 +376,29 @@ void rs232::putchar (char chout)
 /** This method gets one character from the serial port, if one is there.  If not, it
  *  waits until there is a character available.  This can sometimes take a long time
  *  (even forever), so use this function carefully.  One should almost always use
- *  check_for_char() to ensure that there's data available first. 
+ *  check_for_char() to ensure that there's data available first, or subscribe the
+ *  calling task to this port and wait for a wakeup. While the RTOS scheduler is 
+ *  running, the wait is done one tick at a time so that other tasks can run. 
  *  @return The character which was found in the serial port receive buffer
  */
 
 char rs232::getchar (void)
 {
-	uint8_t recv_char;						// Character read from the queue
+	char recv_char;							// Character read from the buffer
 
-	// Wait until there's a character in the receiver queue
-	#ifdef UCSR0A  // If this is a dual-port chip
-		if (port_num == 0)
+	// Wait until there's a character in the receiver buffer
+	while (p_rx->ring.i_get == p_rx->ring.i_put)
+	{
+		if ((SREG & (1 << SREG_I))
+			&& xTaskGetSchedulerState () == taskSCHEDULER_RUNNING)
 		{
-			while (rcv0_read_index == rcv0_write_index);
-			recv_char = rcv0_buffer[rcv0_read_index];
-			if (++rcv0_read_index >= RSINT_BUF_SIZE)
-				rcv0_read_index = 0;
+			vTaskDelay (1);
 		}
-		else  // This is port 1 of a dual-port chip
-		{
-		#if defined UCSR1A
-			while (rcv1_read_index == rcv1_write_index);
-			recv_char = rcv1_buffer[rcv1_read_index];
-			if (++rcv1_read_index >= RSINT_BUF_SIZE)
-				rcv1_read_index = 0;
-		#endif // UCSR1A
-		}
-	#else  // This chip has only one serial port
-		while (rcv0_read_index == rcv0_write_index);
-		recv_char = rcv0_buffer[rcv0_read_index];
-		if (++rcv0_read_index >= RSINT_BUF_SIZE)
-			rcv0_read_index = 0;
-	#endif
+	}
+
+	// Only this method changes the read index, so no critical section is needed
+	recv_char = p_rx->ring.buffer[p_rx->ring.i_get & p_rx->ring.mask];
+	p_rx->ring.i_get++;
 
 	return (recv_char);
 }
@@ -215,14 +413,70 @@ char rs232::getchar (void)
 
 bool rs232::check_for_char (void)
 {
-	#ifdef UCSR1A							// If this is a dual-port chip
-		if (port_num == 0)
-			return (rcv0_read_index != rcv0_write_index);
-		else
-			return (rcv1_read_index != rcv1_write_index);
-	#else									// This chip has only one serial port
-		return (rcv0_read_index != rcv0_write_index);
-	#endif
+	return (p_rx->ring.i_get != p_rx->ring.i_put);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method causes the given task to be woken up each time a character arrives
+ *  in this port's receiver buffer. The task must have called \c enable_wakeups(); it
+ *  can then sleep in \c wait_for_wakeup() rather than calling \c check_for_char() 
+ *  every time it runs. Only one task can be subscribed to a port; subscribing another
+ *  replaces the first, and a \c NULL pointer turns the wakeups off. 
+ *  @param p_task A pointer to the task to be woken when characters arrive
+ */
+
+void rs232::subscribe (TaskBase* p_task)
+{
+	p_rx->p_subscriber = p_task;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method reads one of the 16-bit error counters which are incremented by the 
+ *  receiver ISR. Interrupts are turned off during the read so that the ISR can't 
+ *  change one byte of the counter between the reading of the two bytes. 
+ *  @param counter A reference to the counter to be read
+ *  @return The value of the counter
+ */
+
+uint16_t rs232::read_count (volatile uint16_t& counter)
+{
+	uint8_t old_sreg = SREG;				// Interrupt state, saved for restoring
+	cli ();
+	uint16_t value = counter;
+	SREG = old_sreg;
+
+	return (value);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method prints the state of the serial port's buffers: how many characters are 
+ *  waiting in each buffer, the number of received characters lost to overflows or 
+ *  framing errors, and the number of transmitted characters which had to wait for or 
+ *  were dropped because of a full transmit buffer. The error in the baud rate is also
+ *  shown, with a warning if it's too large for reliable communication. 
+ *  @param ser_dev A reference to the serial device on which to print the status
+ */
+
+void rs232::print_status (emstream& ser_dev)
+{
+	ser_dev << PMS ("Serial ") << port_num
+			<< PMS (": rx ") << (uint8_t)(p_rx->ring.i_put - p_rx->ring.i_get) << '/'
+			<< (uint16_t)(p_rx->ring.mask + 1)
+			<< PMS (", ") << get_rx_overflows () << PMS (" overflows, ")
+			<< get_rx_frame_errors () << PMS (" framing; tx ")
+			<< (uint8_t)(p_tx_ring->i_put - p_tx_ring->i_get) << '/'
+			<< (uint16_t)(p_tx_ring->mask + 1)
+			<< PMS (", ") << tx_blocked << PMS (" blocked, ") << tx_dropped 
+			<< PMS (" dropped; baud error ") << baud_error / 10 << '.' 
+			<< baud_error % 10 << '%';
+	if (baud_error > UART_MAX_BAUD_ERROR)
+	{
+		ser_dev << PMS (" (too large!)");
+	}
+	ser_dev << endl;
 }
 
 
@@ -238,56 +492,122 @@ void rs232::clear_screen (void)
 
 
 //-------------------------------------------------------------------------------------
-/** \cond NOT_ENABLED  (This ISR is not to be documented by Doxygen)
- *  This interrupt service routine runs whenever a character has been received by the
+/** This function does the work of the receiver ISR's for all serial ports. It saves a
+ *  character into the receiver buffer, unless the character arrived with a framing 
+ *  error or there's no room; either way the problem is counted. If the UART reports 
+ *  that it had to throw a character away because the ISR didn't run soon enough, that
+ *  is counted as an overflow too. Then a subscribed task, if any, is woken up. 
+ *  @param rx The receiver buffer belonging to the serial port
+ *  @param status The contents of the port's status register, UCSRnA
+ *  @param mask_FE A bitmask for the framing error bit in the status register
+ *  @param mask_DOR A bitmask for the data overrun bit in the status register
+ *  @param data The character read from the port's data register
+ */
+
+static inline void rsint_receive (rsint_rx_buffer& rx, uint8_t status, 
+								  uint8_t mask_FE, uint8_t mask_DOR, uint8_t data)
+{
+	if (status & mask_DOR)
+	{
+		rx.overflows++;
+	}
+
+	if (status & mask_FE)
+	{
+		rx.frame_errors++;
+		return;
+	}
+
+	// If the buffer is full, the new character is lost; older ones are kept because
+	// only the reader is allowed to move the read index
+	if ((uint8_t)(rx.ring.i_put - rx.ring.i_get) > rx.ring.mask)
+	{
+		rx.overflows++;
+		return;
+	}
+
+	rx.ring.buffer[rx.ring.i_put & rx.ring.mask] = data;
+	rx.ring.i_put++;
+
+	if (rx.p_subscriber != NULL)
+	{
+		rx.p_subscriber->ISR_wake ();
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This interrupt service routine runs whenever a character has been received by the
  *  first serial port (number 0).  It saves that character into the receiver buffer.
+ *  The status register must be read before the data register, as reading the data 
+ *  register clears the error flags. 
  */
 
 ISR (RSI_CHAR_RECV_INT_0)
 {
-	// When this ISR is triggered, there's a character waiting in the USART data reg-
-	// ister, and the write index indexes the place where that character should go
-
 	#if defined UCSR0A  // If this is a dual-serial-port chip (ATmega324P, 128, etc.)
-		rcv0_buffer[rcv0_write_index] = UDR0;
-	#else  // If this chip has only a single serial port (ATmega8, 32, etc.)
-		rcv0_buffer[rcv0_write_index] = UDR;
+		uint8_t status = UCSR0A;
+		rsint_receive (rx_buf_0, status, (1 << FE0), (1 << DOR0), UDR0);
+	#elif defined UCSRA  // If this chip has only a single serial port (ATmega8, 32)
+		uint8_t status = UCSRA;
+		rsint_receive (rx_buf_0, status, (1 << FE), (1 << DOR), UDR);
+	#else  // Old chips such as the AT90S2313 have no overrun flag
+		uint8_t status = USR;
+		rsint_receive (rx_buf_0, status, (1 << FE), 0, UDR);
 	#endif
-
-	// Increment the write pointer
-	if (++rcv0_write_index >= RSINT_BUF_SIZE)
-		rcv0_write_index = 0;
-
-	// If the write pointer is now equal to the read pointer, that means we've just
-	// overwritten the oldest data. Increment the read pointer so that it doesn't seem
-	// as if the buffer is empty
-	if (rcv0_write_index == rcv0_read_index)
-		if (++rcv0_read_index >= RSINT_BUF_SIZE)
-			rcv0_read_index = 0;
 }
 
 
 #ifdef UCSR1A // The second ISR is only compiled for processors with dual serial ports
 	//-------------------------------------------------------------------------------------
 	/** This interrupt service routine runs whenever a character has been received by the
-	*  first serial port (number 0).  It saves that character into the receiver buffer.
+	*  second serial port (number 1).  It saves that character into the receiver buffer.
 	*/
 
 	ISR (RSI_CHAR_RECV_INT_1)
 	{
-		// Read the character from the serial port receiver buffer
-		rcv1_buffer[rcv1_write_index] = UDR1;
-
-		// Increment the write pointer
-		if (++rcv1_write_index >= RSINT_BUF_SIZE)
-			rcv1_write_index = 0;
-
-		// If the write pointer is now equal to the read pointer, that means we've just
-		// overwritten the oldest data. Increment the read pointer so that it doesn't seem
-		// as if the buffer is empty
-		if (rcv1_write_index == rcv1_read_index)
-			if (++rcv1_read_index >= RSINT_BUF_SIZE)
-				rcv1_read_index = 0;
+		uint8_t status = UCSR1A;
+		rsint_receive (rx_buf_1, status, (1 << FE1), (1 << DOR1), UDR1);
+	}
+#endif // Dual serial ports
+
+
+//-------------------------------------------------------------------------------------
+/** This interrupt service routine runs whenever the data register of serial port 0 is
+ *  empty and the data register empty interrupt is enabled. It sends the next 
+ *  character from the transmit buffer; once the buffer is empty, it disables its own
+ *  interrupt until \c putchar() puts more characters in. 
+ */
+
+ISR (RSI_DATA_EMPTY_INT_0)
+{
+	#if defined UCSR0A  // If this is a dual-serial-port chip (ATmega324P, 128, etc.)
+		UCSR0A |= (1 << TXC0);
+		UDR0 = tx_ring_0.buffer[tx_ring_0.i_get & tx_ring_0.mask];
+		if (++tx_ring_0.i_get == tx_ring_0.i_put)
+			UCSR0B &= ~(1 << UDRIE0);
+	#else  // If this chip has only a single serial port (ATmega8, 32, etc.)
+		UCSRA |= (1 << TXC);
+		UDR = tx_ring_0.buffer[tx_ring_0.i_get & tx_ring_0.mask];
+		if (++tx_ring_0.i_get == tx_ring_0.i_put)
+			UCSRB &= ~(1 << UDRIE);
+	#endif
+}
+
+
+#ifdef UCSR1A // The second ISR is only compiled for processors with dual serial ports
+	//-------------------------------------------------------------------------------------
+	/** This interrupt service routine runs whenever the data register of serial port 1
+	 *  is empty and the interrupt is enabled. It sends the next character from the 
+	 *  transmit buffer, disabling itself when the buffer has been emptied. 
+	 */
+
+	ISR (RSI_DATA_EMPTY_INT_1)
+	{
+		UCSR1A |= (1 << TXC1);
+		UDR1 = tx_ring_1.buffer[tx_ring_1.i_get & tx_ring_1.mask];
+		if (++tx_ring_1.i_get == tx_ring_1.i_put)
+			UCSR1B &= ~(1 << UDRIE1);
 	}
 #endif // Dual serial ports
 /** \endcond  (End of section which is not to be documented by Doxygen) */
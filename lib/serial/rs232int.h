@@ -23,6 +23,12 @@
  *    \li 07-05-2008 JRR Changed from 1 to 2 stop bits to placate finicky receivers
  *    \li 12-22-2008 JRR Split off stuff in base232.h for efficiency
  *    \li 06-30-2009 JRR Received data interrupt and buffer added
+ *    \li 10-17-2026 AG  Transmitter interrupt and per-port transmit ring buffers
+ *    \li 10-17-2026 AG  Per-port receive buffers with error counts and task wakeups
+ *    \li 10-17-2026 AG  Baud rates up to 1M; baud rate is 32 bits
+ *    \li 10-17-2026 AG  Added write() which fills the transmit buffer in blocks
+ *    \li 10-17-2026 AG  tx_room() overrides emstream's so the console can use it
+ *    \li 10-17-2026 AG  putchar() doesn't poll when the scheduler is only suspended
  *
  *  License:
  *		This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -45,6 +51,7 @@
 #define _RS232_H_
 
 #include <avr/interrupt.h>					// Header for AVR interrupt programming
+#include "FreeRTOS.h"						// FreeRTOS types such as TickType_t
 #include "base232.h"						// Grab the base RS232-style header file
 #include "emstream.h"				// Pull in the base class header file
 
@@ -73,13 +80,98 @@
 	#endif
 #endif
 
-/** This is the size of the buffer which holds characters received by the serial port.
- *  It is usually set to something fairly large (~100 bytes) so that we don't miss
- *  incoming characters. However, when run on an AVR with very little RAM such as an
- *  ATmega8, ATmega32, ATmega324P or similar, it should usually be set smaller, for
- *  example 20 ~ 30 bytes or so. 
+// The transmitter data register empty interrupts are found the same way
+#if defined USART_UDRE_vect
+	#define RSI_DATA_EMPTY_INT_0 USART_UDRE_vect
+#elif defined USART0_UDRE_vect
+	#define RSI_DATA_EMPTY_INT_0 USART0_UDRE_vect
+#elif defined UART_UDRE_vect
+	#define RSI_DATA_EMPTY_INT_0 UART_UDRE_vect
+#else
+	#error Unable to determine data register empty interrupt vector for this chip
+#endif
+
+#if defined UCSR1A
+	#define RSI_DATA_EMPTY_INT_1 USART1_UDRE_vect
+#endif
+
+/** These are the sizes of the buffers which hold characters received by serial ports
+ *  0 and 1. Each must be a power of two no larger than 128 so that the buffer indices
+ *  can wrap with a mask. They're usually set fairly large so that we don't miss 
+ *  incoming characters, but on an AVR with very little RAM such as an ATmega8, 
+ *  ATmega32, ATmega324P or similar, they should usually be set smaller, for example 
+ *  16 or 32 bytes. They can be overridden in the Makefile, as can the transmit sizes.
+ */
+#ifndef RSINT_RX_BUF_SIZE_0
+	#define RSINT_RX_BUF_SIZE_0	32
+#endif
+#ifndef RSINT_RX_BUF_SIZE_1
+	#define RSINT_RX_BUF_SIZE_1	32
+#endif
+
+/** These are the sizes of the buffers which hold characters waiting to be sent out 
+ *  through serial ports 0 and 1. Each must be a power of two no larger than 128 so 
+ *  that the buffer indices can wrap with a mask. A bigger buffer lets a task dump a 
+ *  long status report and get back to work while the transmitter interrupt sends it;
+ *  they can be overridden in the Makefile with, for example, -DRSINT_TX_BUF_SIZE_1=32.
+ */
+#ifndef RSINT_TX_BUF_SIZE_0
+	#define RSINT_TX_BUF_SIZE_0	64
+#endif
+#ifndef RSINT_TX_BUF_SIZE_1
+	#define RSINT_TX_BUF_SIZE_1	64
+#endif
+
+/** This is the default number of RTOS ticks for which \c putchar() will wait for room
+ *  in a full transmit buffer before giving up and dropping the character. A value of
+ *  zero makes \c putchar() never wait. 
+ */
+#define RSINT_TX_TIMEOUT	100
+
+/** This is the largest number of characters which \c write() copies into the transmit
+ *  buffer in one critical section. Copying a block at a time saves entering and 
+ *  leaving a critical section for each character, but interrupts are held off while 
+ *  the block is copied, so the block is kept short. 
+ */
+#define RSINT_TX_CHUNK		16
+
+
+//-------------------------------------------------------------------------------------
+/** \brief This structure holds a circular buffer which is shared between an \c rs232
+ *  object and the interrupt service routine for the same serial port. 
+ *  \details The indices run freely from 0 to 255; the buffer size must be a power of 
+ *  two, and an index is masked with \c mask to find a location in the buffer. Each 
+ *  index is written by only one side, the task or the ISR, so the number of bytes in
+ *  the buffer is always just \c i_put - \c i_get. 
  */
-#define RSINT_BUF_SIZE		32
+
+struct rsint_ring
+{
+	uint8_t* buffer;						///< Memory in which characters are kept
+	uint8_t mask;							///< Buffer size minus one, for wrapping
+	volatile uint8_t i_put;					///< Count of characters ever put in
+	volatile uint8_t i_get;					///< Count of characters ever taken out
+};
+
+
+class TaskBase;								// Tasks can be woken by the receiver
+
+//-------------------------------------------------------------------------------------
+/** \brief This structure holds the state of a serial port's receiver which is shared
+ *  between an \c rs232 object and the receiver ISR. 
+ *  \details Besides the buffer itself, it counts characters which were lost because 
+ *  the buffer or the UART overflowed and characters thrown away because of framing 
+ *  errors, and it holds a pointer to a task which is to be woken up when a character
+ *  arrives. The counters are only written by the ISR. 
+ */
+
+struct rsint_rx_buffer
+{
+	rsint_ring ring;						///< The received characters
+	volatile uint16_t overflows;			///< Characters lost to a full buffer
+	volatile uint16_t frame_errors;			///< Characters with bad stop bits
+	TaskBase* volatile p_subscriber;		///< Task to wake, or NULL for none
+};
 
 
 //-------------------------------------------------------------------------------------
@@ -94,11 +186,25 @@
  * 
  *  In the version in files \c rs232int.* this class installs an interrupt service
  *  routine (ISR) for receiving characters. When characters arrive in the UART, they
- *  are placed in a buffer whose size is configurable with the macro \c RSINT_BUF_SIZE.
- *  Calls to \c getchar() will check the buffer for received characters. This method,
+ *  are placed in a buffer whose size is configurable with the macros 
+ *  \c RSINT_RX_BUF_SIZE_0 and \c RSINT_RX_BUF_SIZE_1. Calls to \c getchar() will 
+ *  check the buffer for received characters. A character which arrives when the 
+ *  buffer is full is thrown away and counted, as is one with a framing error; the 
+ *  counts are shown by \c print_status(). A task which has called 
+ *  \c enable_wakeups() can be given to \c subscribe() and then sleep in 
+ *  \c wait_for_wakeup() until a character comes in, rather than checking for 
+ *  characters every time it runs. This method,
  *  as opposed to polling the receiver without using interrupts, allows much higher
  *  data rates to be reliably supported in a multitasking program. Sending of 
- *  characters is currently not interrupt based. 
+ *  characters is also interrupt based: \c putchar() puts each character into a 
+ *  transmit buffer whose size is set by \c RSINT_TX_BUF_SIZE_0 or 
+ *  \c RSINT_TX_BUF_SIZE_1, and the data register empty interrupt sends characters
+ *  from that buffer as the UART becomes ready. If the buffer is full, \c putchar() 
+ *  waits up to a timeout (see \c set_tx_timeout()) for the interrupt to make room,
+ *  then drops the character; with a timeout of zero it drops the character right 
+ *  away. When interrupts are disabled, as in \c main() before the scheduler starts 
+ *  or inside a critical section, characters are sent by polling the UART instead. 
+ *  While the scheduler is suspended, characters are buffered but never waited for. 
  * 
  *  \section Usage
  *  To create and use a serial port driver object requires only code such as the
@@ -108,8 +214,11 @@
  *  ser_port << "Hello from test program number " << prog_num << endl;
  *  \endcode
  *  The first parameter to the \c rs232 constructor is the baud rate; 9600 is by far 
- *  the most commonly used. The second parameter is the USART number; use 0 for AVR's
- *  which have only one UART or USART. On AVR's which have a second USART, it is
+ *  the most commonly used. Rates up to 1M baud can be used with a 16 MHz clock; it's 
+ *  a good idea to check the rate at compile time with \c UART_CHECK_BAUD(), as some
+ *  popular rates such as 115200 can't be made accurately from some clocks. The 
+ *  second parameter is the USART number; use 0 for AVR's which have only one UART or
+ *  USART. On AVR's which have a second USART, it is
  *  possible to have two \c rs232 objects, one on USART 0 and one on USART 1. 
  *  The third USART on some AVR's is currently not supported until the author gets a
  *  three-USART chip on which to test new code. 
@@ -121,18 +230,107 @@ class rs232 : public emstream, public base232
 	protected:
 		uint8_t port_num;					///< The USART number, 0 or 1
 
+		/// Pointer to the receiver buffer and counters shared with the receiver ISR
+		rsint_rx_buffer* p_rx;
+
+		/// Pointer to the transmit buffer shared with this port's transmitter ISR
+		rsint_ring* p_tx_ring;
+
+		/// Bitmask for the data register empty interrupt enable bit, UDRIE
+		uint8_t mask_UDRIE;
+
+		/// Number of ticks for which putchar() waits for room in the transmit buffer
+		TickType_t tx_timeout;
+
+		/// Number of times putchar() found the transmit buffer full and had to wait
+		uint16_t tx_blocked;
+
+		/// Number of characters thrown away because the transmit buffer stayed full
+		uint16_t tx_dropped;
+
+		// Send what's in the transmit buffer, then one more character, by polling
+		void send_polled (char);
+
+		// Read a 16-bit counter which is written by an ISR
+		static uint16_t read_count (volatile uint16_t&);
+
 	// Public methods can be called from anywhere in the program where there is a 
 	// pointer or reference to an object of this class
 	public:
 		// The constructor sets up the UART, saving its baud rate and port number
-		rs232 (uint16_t = 9600, uint8_t = 0);
+		rs232 (uint32_t = 9600, uint8_t = 0);
 
 		// This method writes one character to the serial port.
 		void putchar (char);
 
+		// This method writes a block of characters to the serial port
+		uint16_t write (const char* p_data, uint16_t count);
+
+		/** This method sets how long \c putchar() waits for room in a full transmit
+		 *  buffer. A timeout of zero makes transmission non-blocking. 
+		 *  @param ticks The maximum wait in RTOS ticks, or zero to never wait
+		 */
+		void set_tx_timeout (TickType_t ticks)
+		{
+			tx_timeout = ticks;
+		}
+
+		/** This method returns the number of characters which can be written 
+		 *  without having to wait for room in the transmit buffer. It overrides
+		 *  @c emstream::tx_room(), so a shared console can drop text rather than
+		 *  wait for the port.
+		 *  @return The number of free spaces in the transmit buffer
+		 */
+		uint16_t tx_room (void)
+		{
+			return (p_tx_ring->mask + 1
+					- (uint8_t)(p_tx_ring->i_put - p_tx_ring->i_get));
+		}
+
+		/** This method returns the number of times \c putchar() had to wait for 
+		 *  room in the transmit buffer. 
+		 *  @return The number of writes which blocked since the port was set up
+		 */
+		uint16_t get_tx_blocked (void)
+		{
+			return (tx_blocked);
+		}
+
+		/** This method returns the number of characters which were thrown away 
+		 *  because the transmit buffer was full. 
+		 *  @return The number of characters dropped since the port was set up
+		 */
+		uint16_t get_tx_dropped (void)
+		{
+			return (tx_dropped);
+		}
+
+		/** This method returns the number of received characters which were lost
+		 *  because the receiver buffer or the UART itself overflowed. 
+		 *  @return The number of characters lost since the port was set up
+		 */
+		uint16_t get_rx_overflows (void)
+		{
+			return (read_count (p_rx->overflows));
+		}
+
+		/** This method returns the number of received characters which were thrown 
+		 *  away because they had framing errors, usually a sign of a baud rate 
+		 *  mismatch or noise on the line. 
+		 *  @return The number of framing errors since the port was set up
+		 */
+		uint16_t get_rx_frame_errors (void)
+		{
+			return (read_count (p_rx->frame_errors));
+		}
+
+		// Have the receiver ISR wake up the given task when a character arrives
+		void subscribe (TaskBase*);
+
 		bool check_for_char (void);         // Check if a character is in the buffer
 		char getchar (void);                // Get a character; wait if none is ready
 		void clear_screen (void);           // Send the 'clear display screen' code
+		void print_status (emstream&);      // Show buffer usage and error counts
 };
 
 #endif  // _RS232_H_
@@ -0,0 +1,96 @@
+//*************************************************************************************
+/** \file telem_protocol.h
+ *    This file contains the constants which describe telemetry frames: their sizes,
+ *    their CRC, the record types used by the library, and the contents of RTOS trace
+ *    frames. Both ends of the link use them, the AVR through @c telemetry.h and
+ *    @c trace.h and the decoder on the PC directly, so this file must not include any
+ *    AVR headers. The kernel's C files see it through @c trace.h, so the trace event
+ *    codes are written in C and the other constants are for C++ only.
+ *
+ *  Revised:
+ *    \li 10-17-2026 AG  Original file, with the constants from telemetry.h
+ *    \li 10-17-2026 AG  Added the trace event and trace frame codes from trace.h
+ *
+ *  License:
+ *		This file is copyright 2026 by agent (AG) and released under the Lesser GNU 
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+/// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _TELEM_PROTOCOL_H_
+#define _TELEM_PROTOCOL_H_
+
+#include <stdint.h>							// Standard size integer types
+
+
+/** These are the kinds of events which are recorded in an RTOS trace, as sent in
+ *  @c TELEM_TRACE frames. Zero marks an empty record.
+ */
+#define TRACE_NONE              0           ///< Empty record, not yet written
+#define TRACE_SWITCH            1           ///< Task with number @c arg switched in
+#define TRACE_TICK              2           ///< Every 256th RTOS tick, to mark time
+#define TRACE_ISR_BEGIN         3           ///< ISR with number @c arg began
+#define TRACE_ISR_END           4           ///< ISR with number @c arg ended
+#define TRACE_SEND              5           ///< Item sent to queue @c arg
+#define TRACE_RECEIVE           6           ///< Item taken from queue @c arg
+#define TRACE_SEND_FAILED       7           ///< Queue @c arg was full
+#define TRACE_RECEIVE_FAILED    8           ///< Queue @c arg was empty
+#define TRACE_BLOCK_SEND        9           ///< Task will wait until queue has room
+#define TRACE_BLOCK_RECEIVE     10          ///< Task will wait for an item in queue
+#define TRACE_SEND_ISR          11          ///< Item sent to queue by an ISR
+#define TRACE_RECEIVE_ISR       12          ///< Item taken from queue by an ISR
+
+
+// The rest of this file is for C++ code only
+#ifdef __cplusplus
+
+/** This is the largest number of payload bytes which can be sent in one telemetry 
+ *  frame. Each @c telemetry_link holds a frame buffer and an encoding buffer of about
+ *  this size, and senders such as the log queue hold a payload buffer, so this size
+ *  must be kept small; it must also be small enough that an encoded frame needs only
+ *  one COBS code byte, that is, no more than 250.
+ */
+const uint8_t TELEM_MAX_PAYLOAD = 48;
+
+/// This is the number of bytes added to the payload: type, sequence number and CRC.
+const uint8_t TELEM_OVERHEAD = 4;
+
+/// This is the initial value of the CRC which protects each telemetry frame.
+const uint16_t TELEM_CRC_INIT = 0xFFFF;
+
+/** This is the record type used for frames of deferred-format log records, which are
+ *  sent by @c dlog_queue. Programs should number their own record types from 1 to 127.
+ */
+const uint8_t TELEM_LOG = 0x80;
+
+/// This is the record type used for frames which carry an RTOS trace, from trace.cpp.
+const uint8_t TELEM_TRACE = 0x81;
+
+/** These codes are the first byte of each trace frame's payload. A dump is a start
+ *  frame, name frames, frames holding up to @c TRACE_PER_FRAME records each (as set
+ *  in trace.cpp), oldest first, and an end frame. The frames' record type is 
+ *  @c TELEM_TRACE.
+ */
+const uint8_t TRACE_FRAME_START = 0;        ///< Version, buffer size and clock rates
+const uint8_t TRACE_FRAME_NAME = 1;         ///< Kind, number and name of a task or ISR
+const uint8_t TRACE_FRAME_RECORDS = 2;      ///< Records from the buffer
+const uint8_t TRACE_FRAME_END = 3;          ///< The number of records which were sent
+
+/// The kinds of things which are named in name frames.
+const uint8_t TRACE_NAME_TASK = 0;
+const uint8_t TRACE_NAME_ISR = 1;
+
+#endif  // __cplusplus
+
+#endif  // _TELEM_PROTOCOL_H_
@@ -0,0 +1,125 @@
+//*************************************************************************************
+/** \file telemetry.cpp
+ *    This file contains a class which sends binary telemetry records through a serial
+ *    device as COBS-encoded frames protected by a CRC-16. 
+ *
+ *  Revised:
+ *    \li 10-17-2026 AG  Original file
+ *    \li 10-17-2026 AG  Each frame is sent with one call to write()
+ *    \li 10-17-2026 AG  Frames are built in buffers in the link, not on the stack
+ *
+ *  License:
+ *		This file is copyright 2026 by agent (AG) and released under the Lesser GNU 
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+#include <string.h>							// For memcpy()
+#include "telemetry.h"						// Header for this file
+
+
+//-------------------------------------------------------------------------------------
+/** This function encodes a block of bytes with Consistent Overhead Byte Stuffing. The
+ *  result contains no zero bytes: each zero is replaced by a code byte giving the 
+ *  distance to the next zero, and one more code byte is put at the beginning. For 
+ *  blocks of up to 254 bytes, which is all this function handles, the result is 
+ *  exactly one byte longer than the input. 
+ *  @param p_in Pointer to the bytes to be encoded
+ *  @param length The number of bytes to be encoded, no more than 254
+ *  @param p_out Pointer to a buffer of at least \c length + 1 bytes for the result
+ *  @return The number of bytes put into the output buffer
+ */
+
+uint8_t cobs_encode (const uint8_t* p_in, uint8_t length, uint8_t* p_out)
+{
+	uint8_t i_code = 0;						// Where the current code byte goes
+	uint8_t i_out = 1;						// Where the next data byte goes
+	uint8_t code = 1;						// Distance from code byte to next zero
+
+	for (uint8_t i_in = 0; i_in < length; i_in++)
+	{
+		if (p_in[i_in] == 0)
+		{
+			p_out[i_code] = code;
+			i_code = i_out++;
+			code = 1;
+		}
+		else
+		{
+			p_out[i_out++] = p_in[i_in];
+			code++;
+		}
+	}
+	p_out[i_code] = code;
+
+	return (i_out);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This constructor creates a telemetry link which sends frames through the given
+ *  serial device. 
+ *  @param p_dev Pointer to the serial device, usually an \c rs232 port
+ */
+
+telemetry_link::telemetry_link (emstream* p_dev)
+{
+	p_device = p_dev;
+	sequence = 0;
+	frames_sent = 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method sends one record in a frame. The frame is assembled and encoded in
+ *  buffers which belong to the link rather than on the stack, as the sending task
+ *  would otherwise need about a hundred more bytes of stack; then it's written to the
+ *  serial device between two zero bytes. Because of those buffers and the sequence
+ *  number, only one task may send through a given link.
+ *  @param type A number which tells the PC what kind of record this is
+ *  @param p_data Pointer to the bytes of the record
+ *  @param length The number of bytes in the record, up to \c TELEM_MAX_PAYLOAD
+ *  @return True if the record was sent, false if it was too big to fit in a frame
+ */
+
+bool telemetry_link::send (uint8_t type, const void* p_data, uint8_t length)
+{
+	uint16_t crc = TELEM_CRC_INIT;
+
+	if (length > TELEM_MAX_PAYLOAD)
+	{
+		return (false);
+	}
+
+	// Put together the type, sequence number, record and CRC
+	frame[0] = type;
+	frame[1] = sequence++;
+	memcpy (frame + 2, p_data, length);
+	length += 2;
+	for (uint8_t index = 0; index < length; index++)
+	{
+		crc = telem_crc16 (crc, frame[index]);
+	}
+	frame[length++] = (uint8_t)(crc >> 8);
+	frame[length++] = (uint8_t)crc;
+
+	// Encode the frame between a zero on each side and send it with one write(), so
+	// a device which keeps each write together won't let other text into the frame
+	length = cobs_encode (frame, length, encoded + 1);
+	encoded[0] = 0;
+	encoded[++length] = 0;
+	p_device->write ((const char*)encoded, length + 1);
+
+	frames_sent++;
+	return (true);
+}
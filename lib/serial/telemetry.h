@@ -0,0 +1,146 @@
+//*************************************************************************************
+/** \file telemetry.h
+ *    This file contains a class which sends binary telemetry records through a serial
+ *    device. Each record is framed with a type code, a sequence number and a CRC-16,
+ *    then encoded with Consistent Overhead Byte Stuffing (COBS) so that a zero byte 
+ *    can mark the boundaries between frames. A program on the PC finds the frames, 
+ *    checks them, and turns them back into numbers, so the AVR needn't spend time
+ *    converting numbers to text and the serial line carries far fewer bytes. 
+ *
+ *  Revised:
+ *    \li 10-17-2026 AG  Original file
+ *    \li 10-17-2026 AG  Added the record type of RTOS trace frames
+ *    \li 10-17-2026 AG  Frames are built in buffers in the link, not on the stack
+ *    \li 10-17-2026 AG  Moved the frame constants to telem_protocol.h for the PC
+ *
+ *  License:
+ *		This file is copyright 2026 by agent (AG) and released under the Lesser GNU 
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+/// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _TELEMETRY_H_
+#define _TELEMETRY_H_
+
+#include <stdint.h>							// Standard size integer types
+#include "emstream.h"						// Base class for serial devices
+#include "telem_protocol.h"					// Frame sizes and record types
+
+#ifdef __AVR
+	#include <util/crc16.h>					// Fast CRC routines from avr-libc
+#endif
+
+
+//-------------------------------------------------------------------------------------
+/** This function adds one byte to a CRC-16 calculation. The CRC uses the CCITT 
+ *  polynomial 0x1021 with an initial value of 0xFFFF and no final inversion, a variety
+ *  known as CRC-16/CCITT-FALSE; on an AVR the work is done by a fast routine from 
+ *  avr-libc. 
+ *  @param crc The CRC of the bytes before this one
+ *  @param data The byte to be added to the CRC
+ *  @return The CRC including the new byte
+ */
+
+inline uint16_t telem_crc16 (uint16_t crc, uint8_t data)
+{
+	#ifdef __AVR
+		return (_crc_xmodem_update (crc, data));
+	#else
+		crc ^= (uint16_t)data << 8;
+		for (uint8_t bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) 
+								 : (uint16_t)(crc << 1);
+		}
+		return (crc);
+	#endif
+}
+
+
+// Encode a block of bytes with COBS so that the result contains no zeros
+uint8_t cobs_encode (const uint8_t* p_in, uint8_t length, uint8_t* p_out);
+
+
+//-------------------------------------------------------------------------------------
+/** \brief This class sends fixed-layout binary records as COBS-encoded frames through
+ *  a serial device. 
+ *  \details Each frame holds, before encoding, a one-byte record type, a one-byte 
+ *  sequence number which goes up by one for each frame, the record's bytes, and a
+ *  CRC-16 of all of those, high byte first. The frame is COBS-encoded so that it holds
+ *  no zero bytes, and a zero is sent before and after it. 
+ * 
+ *  Because plain text never contains a zero byte, telemetry can share a serial port 
+ *  with the text console: the program on the PC treats anything between zeros which
+ *  isn't a frame with a good CRC as text. If another task prints in the middle of a
+ *  frame, that frame fails its CRC check and is lost, but the text gets through. Using
+ *  a second serial port for telemetry avoids this and leaves the console free. 
+ * 
+ *  Records are sent in the AVR's byte order, which is little-endian, and with no 
+ *  padding, so the structures which describe them should be made of fixed-size
+ *  integer types and marked \c __attribute__((packed)) so the PC sees the same layout.
+ * 
+ *  \section Usage
+ *  \code
+ *  struct my_record { uint32_t time; int16_t reading; } __attribute__((packed));
+ *  ...
+ *  telemetry_link* p_telem = new telemetry_link (p_telem_port);
+ *  ...
+ *  my_record rec;
+ *  rec.time = ...;
+ *  p_telem->send (MY_RECORD_TYPE, rec);
+ *  \endcode
+ */
+
+class telemetry_link
+{
+	protected:
+		emstream* p_device;					///< The device to which frames are sent
+		uint8_t sequence;					///< Sequence number of the next frame
+		uint16_t frames_sent;				///< Number of frames sent so far
+
+		/// The frame is put together here, so it doesn't take room on the stack.
+		uint8_t frame[TELEM_MAX_PAYLOAD + TELEM_OVERHEAD];
+
+		/// The encoded frame, with a zero byte at each end, is put here to be sent.
+		uint8_t encoded[TELEM_MAX_PAYLOAD + TELEM_OVERHEAD + 3];
+
+	public:
+		// The constructor saves the device and starts the sequence numbers at zero
+		telemetry_link (emstream* p_dev);
+
+		// Send one record, given as a block of bytes, in a frame
+		bool send (uint8_t type, const void* p_data, uint8_t length);
+
+		/** This method sends one record whose type is a structure. It saves having to
+		 *  give the record's size and cast its address. 
+		 *  @param type A number which tells the PC what kind of record this is
+		 *  @param record The record to be sent
+		 *  @return True if the record was sent, false if it's too big for a frame
+		 */
+		template <class RecordType> 
+		bool send (uint8_t type, const RecordType& record)
+		{
+			return (send (type, &record, sizeof (RecordType)));
+		}
+
+		/** This method returns the number of frames which have been sent. 
+		 *  @return The number of frames sent since this object was created
+		 */
+		uint16_t get_frames_sent (void)
+		{
+			return (frames_sent);
+		}
+};
+
+#endif  // _TELEMETRY_H_
@@ -12,6 +12,8 @@
  *    \li 10-30-2012 JRR A hopefully somewhat stable version with global queue 
  *                       pointers and the new operator used for most memory allocation
  *    \li 11-04-2012 JRR FreeRTOS Swoop demo program changed to a sweet test suite
+ *    \li 10-17-2026 AG  More stack for source and sink, which now move queue batches
+ *    \li 10-17-2026 AG  User task is woken by the serial port and the print queue
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -46,6 +48,7 @@
 #include "textqueue.h"                      // Wrapper for FreeRTOS character queues
 #include "taskqueue.h"                      // Header of wrapper for FreeRTOS queues
 #include "taskshare.h"                      // Header for thread-safe shared data
+#include "seqshare.h"                       // Shared data with sequence counters
 #include "shares.h"                         // Global ('extern') queue declarations
 #include "task_multi.h"                     // Header for the data acquisition task
 #include "task_source.h"                    // Header for data sending task
@@ -82,6 +85,11 @@ TaskShare<uint32_t>* p_share_1;
  */
 uint32_t glob_of_probs;
 
+/** This shared data item holds a structure which is written by the source task and
+ *  read by the sink task without critical sections, as a test of @c SeqShare.
+ */
+SeqShare<seq_test_data>* p_seq_share;
+
 /** This shared data item is used to test the increment and decrement operators for
  *  shared data items. 
  */
@@ -122,17 +130,23 @@ int main (void)
 	// the sink task.
 	p_share_1 = new TaskShare<uint32_t> ("Test Share");
 
+	// This shared data item holds a structure which is read while it's being changed
+	p_seq_share = new SeqShare<seq_test_data> ("Seq Share");
+
 	// This shared data item is used to test the increment and decrement operators for
 	// shared data items. 
 	p_share_counter = new TaskShare<int8_t> ("Count");
 
 	// Create the data source and sink tasks
-	new task_source ("Source", task_priority (2), 120, p_ser_port);
-	new task_sink ("Sink", task_priority (2), 140, p_ser_port);
+	new task_source ("Source", task_priority (2), 140, p_ser_port);
+	new task_sink ("Sink", task_priority (2), 160, p_ser_port);
 
 	// The user interface is at low priority; it could have been run in the idle task
 	// but it is desired to exercise the RTOS more thoroughly in this test program.
-	new task_user ("UserInt", task_priority (1), 260, p_ser_port);
+	task_user* p_user_task
+		= new task_user ("UserInt", task_priority (1), 260, p_ser_port);
+	p_ser_port->subscribe (p_user_task);
+	p_print_ser_queue->subscribe (p_user_task);
 
 	// Create a set of tasks from the task_multi class. This is to test how things work
 	// when there are a whole bunch of tasks operating
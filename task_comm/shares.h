@@ -7,6 +7,7 @@
  *    \li 09-30-2012 JRR Original file was a one-file demonstration with two tasks
  *    \li 10-05-2012 JRR Split into multiple files, one for each task plus a main one
  *    \li 10-29-2012 JRR Reorganized with global queue and shared data references
+ *    \li 10-17-2026 AG  Added a sequence counted share of a two-word structure
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -45,6 +46,7 @@
  *    task_source -> task_sink [ label = "queue_1\nuint32_t" ];
  *    task_source -> task_sink [ label = "share_1\nuint32_t", style = dashed ];
  *    task_source -> task_sink [ label = "glob_of_probs\nuint32_t", style = dotted ];
+ *    task_source -> task_sink [ label = "seq_share\nseq_test_data", style = dashed ];
  *    task_multi1 -> task_user [ label = "print_ser_queue\nchar" ];
  *    task_multi2 -> task_user [ label = "print_ser_queue\nchar" ];
  *    task_multiN -> task_user [ label = "print_ser_queue\nchar" ];
@@ -113,6 +115,21 @@ extern TaskShare<uint32_t>* p_share_1;
  */
 extern uint32_t glob_of_probs;
 
+/*  This structure is sent through a sequence counted share. The check word is always
+ *  the complement of the value, so a reader can tell if it got half of one write and
+ *  half of another.
+ */
+struct seq_test_data
+{
+	uint32_t value;                         // Data which changes with each write
+	uint32_t check;                         // Always equal to ~value
+};
+
+/*  This shared data item has the source task send the sink task a structure which
+ *  can't be copied in one instruction, and no critical section protects the copy.
+ */
+extern SeqShare<seq_test_data>* p_seq_share;
+
 /*  This shared data item is used to test the increment and decrement operators for
  *  shared data items. 
  */
@@ -42,6 +42,7 @@
 #include "time_stamp.h"                     // Class to implement a microsecond timer
 #include "taskqueue.h"                      // Header of wrapper for FreeRTOS queues
 #include "taskshare.h"                      // Header for thread-safe shared data
+#include "seqshare.h"                       // Shared data with sequence counters
 
 
 //-------------------------------------------------------------------------------------
@@ -9,6 +9,8 @@
  *    \li 10-05-2012 JRR Split into multiple files, one for each task
  *    \li 10-25-2012 JRR Changed to a more fully C++ version with class task_sender
  *    \li 11-03-2012 JRR Morphed again into a data sink task with error checks
+ *    \li 10-17-2026 AG  Checks data from a sequence counted share too
+ *    \li 10-17-2026 AG  Takes items from the queue in batches with @c drain_into()
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -52,6 +54,7 @@ task_sink::task_sink (const char* a_name,
 	queue_errors = 0;
 	share_errors = 0;
 	global_errors = 0;
+	seq_errors = 0;
 }
 
 
@@ -64,7 +67,8 @@ void task_sink::show_errors (void)
 {
 	*p_print_ser_queue << PMS ("Transmission errors in queue ") << queue_errors
 					   << PMS (", shared_data ") << share_errors
-					   << PMS (", global data ") << global_errors << endl;
+					   << PMS (", global data ") << global_errors
+					   << PMS (", seq share ") << seq_errors << endl;
 }
 
 
@@ -77,6 +81,8 @@ void task_sink::run (void)
 {
 	// Setup
 	uint32_t received_data = 0x12345678;
+	uint32_t batch[SOURCE_BATCH];           // Items taken from the queue at once
+	uint8_t batch_size;                     // How many items were in the queue
 
 	// Wait a moment before starting the loop so that the source task has time to make
 	// some data available
@@ -86,11 +92,12 @@ void task_sink::run (void)
 	// above, the task loop runs, and it keeps running until the power is shut off
 	for (;;)
 	{
-		// Check the queue from the source task. If there's data, read it; if not, go
-		// and check the shared data
-		if (p_queue_1->not_empty ())
+		// Check the queue from the source task. If there's data, read whatever is
+		// there in one batch; if not, go and check the shared data
+		batch_size = p_queue_1->drain_into (batch, SOURCE_BATCH);
+		for (uint8_t index = 0; index < batch_size; index++)
 		{
-			received_data = p_queue_1->get ();
+			received_data = batch[index];
 			if ((received_data & 0x00FF00FF) != 0)
 			{
 				queue_errors++;
@@ -107,6 +114,14 @@ void task_sink::run (void)
 			*p_print_ser_queue << PMS ("ERROR in share, got ") << hex << received_data
 							   << dec << endl;
 		}
+		// The two halves of the structure in the sequence counted share must match
+		seq_test_data seq_data = p_seq_share->get ();
+		if (seq_data.check != ~seq_data.value)
+		{
+			seq_errors++;
+			*p_print_ser_queue << PMS ("ERROR in seq share, got ") << hex 
+							   << seq_data.value << '/' << seq_data.check << dec << endl;
+		}
 		received_data = glob_of_probs;
 		if (received_data != 0x87654321 && received_data != 0x12345678)
 		{
@@ -136,6 +151,7 @@ void task_sink::print_status (emstream& ser_thing)
 	// Show errors in transmission
 	ser_thing << PMS ("\tErrors in queue: ") << queue_errors
 			  << PMS (", shared_data: ") << share_errors
-			  << PMS (", global data: ") << global_errors;
+			  << PMS (", global data: ") << global_errors
+			  << PMS (", seq share: ") << seq_errors;
 }
 
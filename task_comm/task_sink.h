@@ -9,6 +9,7 @@
  *    \li 10-05-2012 JRR Split into multiple files, one for each task
  *    \li 10-25-2012 JRR Changed to a more fully C++ version with class task_sender
  *    \li 11-03-2012 JRR Morphed again into a data sink task with error checks
+ *    \li 10-17-2026 AG  Checks data from a sequence counted share too
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -41,6 +42,7 @@
 #include "taskqueue.h"                      // Header of wrapper for FreeRTOS queues
 #include "textqueue.h"                      // Header for text queue class
 #include "taskshare.h"                      // Header for thread-safe shared data
+#include "seqshare.h"                       // Shared data with sequence counters
 #include "shares.h"                         // Global ('extern') queue declarations
 
 
@@ -63,6 +65,9 @@ protected:
 	/// This is the number of errors in the data shared by a global variable.
 	uint32_t global_errors;
 
+	/// This is the number of torn structures read from the sequence counted share.
+	uint32_t seq_errors;
+
 public:
 	// This constructor creates a data sender task object
 	task_sink (const char*, unsigned portBASE_TYPE, size_t, emstream*);
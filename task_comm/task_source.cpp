@@ -9,6 +9,8 @@
  *    \li 09-30-2012 JRR Original file was a one-file demonstration with two tasks
  *    \li 10-05-2012 JRR Split into multiple files, one for each task
  *    \li 11-04-2012 JRR Changed into the test data source task
+ *    \li 10-17-2026 AG  Also writes a structure into a sequence counted share
+ *    \li 10-17-2026 AG  Every other run sends a batch of queue items with @c put_n()
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -62,14 +64,27 @@ void task_source::run (void)
 	// Set up by declaring and initializing variables
 	uint32_t some_data = 0;
 	uint8_t toggler = false;
+	uint32_t batch[SOURCE_BATCH];           // Items sent to the queue all at once
 
 	// This is the task loop. Once the task has been initialized in the code just
 	// above, the task loop runs, and it keeps running until the power is shut off
 	for (;;)
 	{
-		// Create some data and send it to the sink task in the queue
+		// Create some data and send it to the sink task in the queue. Every other
+		// time, send a batch of items at once to test put_n()
 		some_data = random ();
-		p_queue_1->put (some_data & 0xFF00FF00);
+		if (toggler)
+		{
+			p_queue_1->put (some_data & 0xFF00FF00);
+		}
+		else
+		{
+			for (uint8_t index = 0; index < SOURCE_BATCH; index++)
+			{
+				batch[index] = (some_data << index) & 0xFF00FF00;
+			}
+			p_queue_1->put_n (batch, SOURCE_BATCH);
+		}
 
 		// Write standard values here; we'll check what is received by the sink
 		if (toggler)
@@ -84,6 +99,12 @@ void task_source::run (void)
 		}
 		toggler ^= 0x01;
 
+		// Put a structure whose two halves must match into the sequence counted share
+		seq_test_data seq_data;
+		seq_data.value = some_data;
+		seq_data.check = ~some_data;
+		p_seq_share->put (seq_data);
+
 		// Increment the counter so we can check how many times this task has run
 		runs++;
 
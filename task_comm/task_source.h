@@ -9,6 +9,7 @@
  *    \li 09-30-2012 JRR Original file was a one-file demonstration with two tasks
  *    \li 10-05-2012 JRR Split into multiple files, one for each task
  *    \li 11-04-2012 JRR Changed into the test data source task
+ *    \li 10-17-2026 AG  Added the size of batches sent through the queue
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -42,6 +43,7 @@
 #include "taskqueue.h"                      // Header for generic RTOS queue class
 #include "textqueue.h"                      // Header for RTOS text queue class
 #include "taskshare.h"                      // Header for thread-safe shared data
+#include "seqshare.h"                       // Shared data with sequence counters
 
 #include "shares.h"                         // Global ('extern') queue declarations
 
@@ -53,6 +55,12 @@
  */
 const TickType_t DEF_TICKS_PER_RUN = configTICK_RATE_HZ;         // For 1 Hz updates
 
+/** This is the number of items which the source task puts into the queue at once 
+ *  with @c put_n() every other time it runs. The sink task takes items out of the
+ *  queue with @c drain_into() in batches of up to this many as well.
+ */
+const uint8_t SOURCE_BATCH = 4;
+
 
 //-------------------------------------------------------------------------------------
 // Externs:  In this section, we declare variables and functions that are used in all
@@ -8,6 +8,8 @@
  *    \li 10-05-2012 JRR Split into multiple files, one for each task
  *    \li 10-25-2012 JRR Changed to a more fully C++ version with class task_user
  *    \li 11-04-2012 JRR Modified from the data acquisition example to the test suite
+ *    \li 10-17-2026 AG  Prints whole spans of text from the print queue at once
+ *    \li 10-17-2026 AG  Sleeps until a key is pressed or text is queued for printing
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -55,6 +57,8 @@ task_user::task_user (const char* a_name,
 					 )
 	: TaskBase (a_name, a_priority, a_stack_size, p_ser_dev)
 {
+	// Let the serial port and the print queue wake this task when there's input
+	enable_wakeups ();
 }
 
 
@@ -143,13 +147,20 @@ void task_user::run (void)
 		// has sent this task something to be printed
 		else if (p_print_ser_queue->check_for_char ())
 		{
-			p_serial->putchar (p_print_ser_queue->getchar ());
+			const char* p_text;
+			uint16_t length = p_print_ser_queue->get_span (p_text);
+			for (uint16_t count = 0; count < length; count++)
+			{
+				p_serial->putchar (p_text[count]);
+			}
+			p_print_ser_queue->consume (length);
 		}
 		// If no character has been typed and no other task sent us something to print, 
-		// wait for approximately a millisecond before we check again
+		// sleep until the serial port or the print queue wakes this task up
 		else	
 		{
-			delay_ms (1);
+			wait_for_wakeup (((uint32_t)USER_IDLE_TIMEOUT_MS * configTICK_RATE_HZ)
+							 / 1000UL);
 		}
 
 		// We've made it safely through the loop one more time; claim some credit
@@ -198,6 +209,7 @@ void task_user::show_status (void)
 			  #else
 				<< PMS (", OCR1A=") << OCR1A << endl;
 			  #endif
+	p_serial->print_status (*p_serial);
 
 	// Have the tasks print their status; then the same for the shared data items
 	print_task_list (p_serial);
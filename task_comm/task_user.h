@@ -8,6 +8,7 @@
  *    \li 10-05-2012 JRR Split into multiple files, one for each task
  *    \li 10-25-2012 JRR Changed to a more fully C++ version with class task_user
  *    \li 11-04-2012 JRR Modified from the data acquisition example to the test suite
+ *    \li 10-17-2026 AG  Sleeps until a key is pressed or text is queued for printing
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -41,6 +42,7 @@
 #include "taskqueue.h"                      // Header of wrapper for FreeRTOS queues
 #include "textqueue.h"                      // Header for a "<<" queue class
 #include "taskshare.h"                      // Header for thread-safe shared data
+#include "seqshare.h"                       // Shared data with sequence counters
 
 #include "shares.h"							// Global ('extern') queue declarations
 
@@ -48,6 +50,12 @@
 /// This macro defines a string that identifies the name and version of this program. 
 #define PROGRAM_VERSION		PMS ("ME405/FreeRTOS Task Communication Test")
 
+/** This is the longest time in milliseconds for which the user interface task sleeps.
+ *  The task is woken when a character arrives at the serial port or text is put into
+ *  the print queue, so this timeout is only a backstop. 
+ */
+#define USER_IDLE_TIMEOUT_MS 100
+
 
 //-------------------------------------------------------------------------------------
 /** This task reads measurements that were taken by the data acquisition task in